@@ -0,0 +1,129 @@
+/**
+ *
+ * @file column_decoder_bench.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Microbenchmark of whole-column numeric decoding against one std::from_chars per cell
+ *
+ * Needs no server. Build it once per instruction set to compare, for example:
+ *     g++ -O2 -std=c++17 -I.. column_decoder_bench.cpp ../column_decoder.cpp -o bench_scalar
+ *     g++ -O2 -std=c++17 -msse4.1 -I.. column_decoder_bench.cpp ../column_decoder.cpp -o bench_sse41
+ *     g++ -O2 -std=c++17 -march=native -I.. column_decoder_bench.cpp ../column_decoder.cpp -o bench_native
+ * Optional argument: number of cells per column (default 4000000).
+ */
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "column_decoder.h"
+
+/**
+ * A synthetic column: every cell packed into one buffer, like the client library keeps them.
+ */
+struct Column
+{
+	std::string bytes; /**<Cell text, each followed by a null character.*/
+	std::vector<const char*> cells; /**<Start of every cell.*/
+	std::vector<unsigned long> lengths; /**<Length of every cell.*/
+};
+
+/**
+ * Builds a column from a cell generator.
+ */
+template <typename Generator>
+static Column makeColumn(size_t count, Generator next)
+{
+	Column column;
+	std::vector<size_t> offsets;
+	offsets.reserve(count);
+	column.lengths.reserve(count);
+	for(size_t i = 0; i < count; i++)
+	{
+		std::string cell = next();
+		offsets.push_back(column.bytes.size());
+		column.lengths.push_back(static_cast<unsigned long>(cell.size()));
+		column.bytes += cell;
+		column.bytes.push_back('\0');
+	}
+	for(size_t offset : offsets)
+	{
+		column.cells.push_back(column.bytes.data() + offset);
+	}
+	return column;
+}
+
+/**
+ * Runs fn a few times and keeps the fastest run.
+ * @return Nanoseconds per cell of the fastest run.
+ */
+template <typename Fn>
+static double timeIt(size_t count, Fn fn)
+{
+	double best = 1e300;
+	for(int run = 0; run < 5; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		best = ns < best ? ns : best;
+	}
+	return best / static_cast<double>(count);
+}
+
+/**
+ * Decodes a column both ways, checks the results agree and prints the timings.
+ */
+template <typename T, typename Decoder>
+static bool bench(const char* name, const Column& column, Decoder decode)
+{
+	size_t count = column.cells.size();
+	std::vector<T> naive(count), fast(count);
+	double naiveNs = timeIt(count, [&]() {
+		for(size_t i = 0; i < count; i++)
+		{
+			std::from_chars(column.cells[i], column.cells[i] + column.lengths[i], naive[i]);
+		}
+	});
+	size_t decoded = 0;
+	double fastNs = timeIt(count, [&]() {decoded = decode(column.cells.data(), column.lengths.data(), count, fast.data());});
+	bool same = decoded == count && naive == fast;
+	std::printf("%-20s from_chars %6.2f ns/cell   column decoder %6.2f ns/cell   speedup %5.2fx   %s\n",
+	            name, naiveNs, fastNs, naiveNs / fastNs, same ? "ok" : "MISMATCH");
+	return same;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+	std::mt19937_64 rng(42);
+
+	Column ints = makeColumn(count, [&]() {return std::to_string(static_cast<int32_t>(rng()));});
+	Column smallInts = makeColumn(count, [&]() {return std::to_string(rng() % 100000);});
+	Column bigints = makeColumn(count, [&]() {return std::to_string(static_cast<int64_t>(rng()) >> (rng() % 40));});
+	Column ids = makeColumn(count, [&]() {return std::to_string(rng() >> 20);});
+	Column prices = makeColumn(count, [&]() {
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.2f", static_cast<double>(rng() % 10000000) / 100.0);
+		return std::string(buffer);
+	});
+	Column doubles = makeColumn(count, [&]() {
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.17g", std::uniform_real_distribution<double>(-1e6, 1e6)(rng));
+		return std::string(buffer);
+	});
+
+	std::printf("column decoder instruction set: %s, %zu cells per column\n", columnDecoderInstructionSet(), count);
+	bool ok = true;
+	ok &= bench<int64_t>("INT", ints, decodeInt64Column);
+	ok &= bench<int64_t>("SMALL INT", smallInts, decodeInt64Column);
+	ok &= bench<int64_t>("BIGINT", bigints, decodeInt64Column);
+	ok &= bench<uint64_t>("BIGINT UNSIGNED", ids, decodeUInt64Column);
+	ok &= bench<double>("DOUBLE (2 decimals)", prices, decodeDoubleColumn);
+	ok &= bench<double>("DOUBLE (17 digits)", doubles, decodeDoubleColumn);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,745 @@
+/**
+ *
+ * @file connector_bench.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief End to end benchmark of the Connector against a throwaway local server, reported as JSON
+ *
+ * Starts a private mysqld (MySQL or MariaDB) in a temp directory listening only on a unix socket, loads a synthetic
+ * table and times connecting, point selects, streaming and buffered scans, the getData() copy and inserts. The server and its
+ * data directory are removed afterwards. Build and run, for example:
+ *     g++ -O2 -std=c++17 -I.. $(mysql_config --cflags) connector_bench.cpp ../connector.cpp ../cursor.cpp ../result.cpp \
+ *         ../columnar_result.cpp ../column_decoder.cpp ../spillable_result.cpp ../statement.cpp ../statement_cache.cpp \
+ *         ../bulk_inserter.cpp fake_server.cpp ../metrics.cpp ../query_cache.cpp ../query_recorder.cpp ../runtime.cpp \
+ *         $(mysql_config --libs) -o connector_bench
+ *     ./connector_bench --rows 200000 --width 8 --out before.json
+ *
+ * Options:
+ *     --mysqld PATH      Server binary to start (default mysqld, looked up in PATH).
+ *     --install-db PATH  MariaDB only: data directory initializer (default mariadb-install-db).
+ *     --socket PATH      Use an already running server on this socket instead of starting one.
+ *     --fake             Use an in-process FakeServer (fake_server.h) answering with canned results instead of mysqld,
+ *                        so only client-side costs are measured. Inserts and DDL are acknowledged without doing anything.
+ *     --user NAME        User to connect as (default root). --pass PASSWORD for its password.
+ *     --rows N           Rows in the synthetic table (default 100000).
+ *     --width N          Columns in the synthetic table, the id included (default 8).
+ *     --iterations N     Point selects and single row inserts to time (default 5000).
+ *     --compress ALGO    Protocol compression for every connection: none, zlib or zstd (default none).
+ *     --zstd-level N     zstd level, 1 to 22 (default 3).
+ *     --out FILE         Write the JSON report to FILE instead of stdout.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bulk_inserter.h"
+#include "fake_server.h"
+#include "connector.h"
+#include "cursor.h"
+#include "metrics.h"
+#include "result.h"
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * Command line options.
+ */
+struct Options
+{
+	std::string mysqld = "mysqld"; /**<Server binary to start.*/
+	std::string installDb = "mariadb-install-db"; /**<MariaDB data directory initializer.*/
+	std::string socket; /**<Socket of an already running server, empty to start one.*/
+	std::string user = "root"; /**<User to connect as.*/
+	std::string pass; /**<Password of the user.*/
+	size_t rows = 100000; /**<Rows in the synthetic table.*/
+	unsigned width = 8; /**<Columns in the synthetic table.*/
+	size_t iterations = 5000; /**<Point selects and single row inserts to time.*/
+	std::string out; /**<File the report is written to, empty for stdout.*/
+	bool fake = false; /**<If the queries are answered by an in-process FakeServer.*/
+	Compression compression = Compression::NONE; /**<Protocol compression of every connection.*/
+	unsigned zstdLevel = 3; /**<zstd level when compression is zstd.*/
+};
+
+/**
+ * Nanoseconds elapsed since start.
+ */
+static uint64_t elapsedNs(clock_type::time_point start)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count());
+}
+
+/**
+ * Runs a program with its output appended to a log file.
+ * @param args Program followed by its arguments.
+ * @param log File receiving stdout and stderr.
+ * @return Process id, -1 if it could not be started.
+ */
+static pid_t spawn(const std::vector<std::string>& args, const std::string& log)
+{
+	pid_t pid = fork();
+	if(pid == 0)
+	{
+		int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if(fd >= 0)
+		{
+			dup2(fd, STDOUT_FILENO);
+			dup2(fd, STDERR_FILENO);
+			close(fd);
+		}
+		std::vector<char*> argv;
+		for(const std::string& arg : args)
+		{
+			argv.push_back(const_cast<char*>(arg.c_str()));
+		}
+		argv.push_back(nullptr);
+		execvp(argv[0], argv.data());
+		_exit(127);
+	}
+	return pid;
+}
+
+/**
+ * Reads a whole text file, empty if it does not exist.
+ */
+static std::string readFile(const std::string& path)
+{
+	std::ifstream in(path);
+	std::stringstream text;
+	text << in.rdbuf();
+	return text.str();
+}
+
+/**
+ * A private server living in a temp directory for as long as the object does.
+ */
+class ServerFixture
+{
+	std::string _dir; /**<Temp directory holding the data directory, socket and logs.*/
+	pid_t _pid = -1; /**<Process id of the running server.*/
+	std::string _error; /**<String that stores any error messages that is encountered*/
+
+	public:
+	ServerFixture() = default;
+	ServerFixture(const ServerFixture& server) = delete;
+	ServerFixture& operator=(const ServerFixture& rhs) = delete;
+
+	/**
+	 * Initializes a data directory, starts the server on it and waits until it accepts connections.
+	 * @return If the server is up or not.
+	 */
+	bool start(const Options& options, ConnectionOptions& connection)
+	{
+		char dir[] = "/tmp/connector-bench-XXXXXX";
+		if(!mkdtemp(dir))
+		{
+			_error = std::string("Could not create a temp directory: ") + std::strerror(errno);
+			return false;
+		}
+		_dir = dir;
+		std::string data = _dir + "/data";
+		std::string socket = _dir + "/mysql.sock";
+		std::string log = _dir + "/server.log";
+
+		std::string version;
+		if(FILE* pipe = popen((options.mysqld + " --version 2>&1").c_str(), "r"))
+		{
+			char buffer[256];
+			while(std::fgets(buffer, sizeof(buffer), pipe))
+			{
+				version += buffer;
+			}
+			pclose(pipe);
+		}
+		bool mariadb = version.find("MariaDB") != std::string::npos;
+		bool root = geteuid() == 0;
+
+		std::vector<std::string> init;
+		if(mariadb)
+		{
+			init = {options.installDb, "--no-defaults", "--datadir=" + data, "--auth-root-authentication-method=normal", "--skip-test-db"};
+		}
+		else
+		{
+			init = {options.mysqld, "--no-defaults", "--initialize-insecure", "--datadir=" + data};
+		}
+		if(root)
+		{
+			init.push_back("--user=root");
+		}
+		int status = 0;
+		pid_t initPid = spawn(init, log);
+		if(initPid < 0 || waitpid(initPid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			_error = "Initializing the data directory failed:\n" + readFile(log);
+			return false;
+		}
+
+		std::vector<std::string> server = {options.mysqld, "--no-defaults", "--datadir=" + data, "--socket=" + socket,
+		                                   "--pid-file=" + _dir + "/mysqld.pid", "--log-error=" + log, "--skip-networking",
+		                                   "--skip-log-bin", "--innodb-buffer-pool-size=256M", "--max-allowed-packet=64M"};
+		if(!mariadb)
+		{
+			server.push_back("--mysqlx=OFF");
+		}
+		if(root)
+		{
+			server.push_back("--user=root");
+		}
+		_pid = spawn(server, log);
+		if(_pid < 0)
+		{
+			_error = "Could not start " + options.mysqld + ".";
+			return false;
+		}
+
+		connection.unix_socket = socket;
+		clock_type::time_point deadline = clock_type::now() + std::chrono::seconds(60);
+		while(clock_type::now() < deadline)
+		{
+			if(waitpid(_pid, &status, WNOHANG) == _pid)
+			{
+				_pid = -1;
+				_error = "The server exited during startup:\n" + readFile(log);
+				return false;
+			}
+			Connector probe;
+			if(probe.connect(connection))
+			{
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		_error = "The server did not accept connections within 60 seconds:\n" + readFile(log);
+		return false;
+	}
+
+	/**
+	 * Shuts the server down and removes its directory.
+	 */
+	void stop()
+	{
+		if(_pid > 0)
+		{
+			kill(_pid, SIGTERM);
+			waitpid(_pid, nullptr, 0);
+			_pid = -1;
+		}
+		if(!_dir.empty())
+		{
+			std::error_code ignored;
+			std::filesystem::remove_all(_dir, ignored);
+			_dir.clear();
+		}
+	}
+
+	inline std::string getError() const {return _error;}
+
+	~ServerFixture()
+	{
+		stop();
+	}
+};
+
+/**
+ * Builds the JSON report one result at a time.
+ */
+class Report
+{
+	std::vector<std::string> _results; /**<"name": {...} members of the results object.*/
+
+	public:
+	/**
+	 * Adds a result with latency percentiles taken from a histogram.
+	 */
+	void addLatency(const std::string& name, const HistogramSnapshot& latency, double seconds, const std::string& extra = std::string())
+	{
+		char buffer[512];
+		std::snprintf(buffer, sizeof(buffer),
+		              "\"count\": %llu, \"ops_per_sec\": %.1f, \"mean_ns\": %llu, \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu",
+		              static_cast<unsigned long long>(latency.count), seconds > 0 ? static_cast<double>(latency.count) / seconds : 0.0,
+		              static_cast<unsigned long long>(latency.count ? latency.sum / latency.count : 0),
+		              static_cast<unsigned long long>(latency.percentile(50)), static_cast<unsigned long long>(latency.percentile(90)),
+		              static_cast<unsigned long long>(latency.percentile(99)), static_cast<unsigned long long>(latency.percentile(99.9)),
+		              static_cast<unsigned long long>(latency.max));
+		add(name, std::string(buffer) + extra);
+	}
+
+	/**
+	 * Adds a result made of ready formatted JSON members.
+	 */
+	void add(const std::string& name, const std::string& members)
+	{
+		_results.push_back("    \"" + name + "\": {" + members + "}");
+	}
+
+	/**
+	 * Renders the whole report.
+	 */
+	std::string render(const Options& options, const std::string& server, bool ok) const
+	{
+		std::string json = "{\n  \"benchmark\": \"connector_bench\",\n";
+		json += std::string("  \"mode\": \"") + (options.fake ? "fake" : options.socket.empty() ? "mysqld" : "external") + "\",\n";
+		json += "  \"client\": \"" + std::string(mysql_get_client_info()) + "\",\n";
+		json += "  \"server\": \"" + server + "\",\n";
+		json += "  \"rows\": " + std::to_string(options.rows) + ",\n";
+		json += "  \"width\": " + std::to_string(options.width) + ",\n";
+		json += "  \"iterations\": " + std::to_string(options.iterations) + ",\n";
+		json += std::string("  \"compression\": \"") + (options.compression == Compression::ZSTD ? "zstd" : options.compression == Compression::ZLIB ? "zlib" : "none") + "\",\n";
+		json += std::string("  \"ok\": ") + (ok ? "true" : "false") + ",\n";
+		json += "  \"results\": {\n";
+		for(size_t i = 0; i < _results.size(); i++)
+		{
+			json += _results[i] + (i + 1 < _results.size() ? ",\n" : "\n");
+		}
+		json += "  }\n}\n";
+		return json;
+	}
+};
+
+/**
+ * Column list of the synthetic table: the id, then INT, DOUBLE and VARCHAR columns in turn.
+ */
+static std::string tableDefinition(unsigned width)
+{
+	std::string sql = "(id BIGINT NOT NULL PRIMARY KEY";
+	for(unsigned i = 1; i < width; i++)
+	{
+		static const char* TYPES[] = {" INT", " DOUBLE", " VARCHAR(32)"};
+		sql += ", c" + std::to_string(i) + TYPES[(i - 1) % 3];
+	}
+	return sql + ") ENGINE=InnoDB";
+}
+
+/**
+ * Text of the cells of one synthetic row, in column order.
+ */
+static std::vector<std::string> rowCells(unsigned width, int64_t id, std::mt19937_64& rng)
+{
+	std::vector<std::string> cells = {std::to_string(id)};
+	for(unsigned i = 1; i < width; i++)
+	{
+		char buffer[32];
+		switch((i - 1) % 3)
+		{
+			case 0: cells.push_back(std::to_string(static_cast<int32_t>(rng()))); break;
+			case 1: std::snprintf(buffer, sizeof(buffer), "%.2f", static_cast<double>(rng() % 10000000) / 100.0); cells.push_back(buffer); break;
+			default: cells.push_back("value-" + std::to_string(rng() % 1000000000)); break;
+		}
+	}
+	return cells;
+}
+
+/**
+ * Adds one synthetic row to a BulkInserter.
+ */
+static bool addRow(BulkInserter& inserter, unsigned width, int64_t id, std::mt19937_64& rng)
+{
+	std::vector<std::string> cells = rowCells(width, id, rng);
+	inserter.addInt64(id);
+	for(unsigned i = 1; i < width; i++)
+	{
+		switch((i - 1) % 3)
+		{
+			case 0: inserter.addInt64(std::strtoll(cells[i].c_str(), nullptr, 10)); break;
+			case 1: inserter.addDouble(std::strtod(cells[i].c_str(), nullptr)); break;
+			default: inserter.addString(cells[i]); break;
+		}
+	}
+	return inserter.endRow();
+}
+
+/**
+ * Registers the synthetic table with a FakeServer: the full table scan, and any point select by id, which is
+ * answered with the first row. Every other statement gets an OK packet.
+ */
+static bool loadFakeServer(FakeServer& fake, const Options& options)
+{
+	static const enum_field_types TYPES[] = {MYSQL_TYPE_LONG, MYSQL_TYPE_DOUBLE, MYSQL_TYPE_VAR_STRING};
+	FakeServer::ResultSet table;
+	table.columns.push_back({"id", MYSQL_TYPE_LONGLONG, false});
+	for(unsigned i = 1; i < options.width; i++)
+	{
+		table.columns.push_back({"c" + std::to_string(i), TYPES[(i - 1) % 3], false});
+	}
+	std::mt19937_64 rng(42);
+	table.rows.reserve(options.rows);
+	for(size_t i = 0; i < options.rows; i++)
+	{
+		std::vector<std::string> cells = rowCells(options.width, static_cast<int64_t>(i + 1), rng);
+		table.rows.emplace_back(cells.begin(), cells.end());
+	}
+
+	FakeServer::ResultSet point;
+	point.columns = table.columns;
+	point.rows.push_back(table.rows.front());
+	return fake.setResult("SELECT * FROM bench_rows", table) && fake.setResult("SELECT * FROM bench_rows WHERE id = ", point, true);
+}
+
+/**
+ * Column names of the synthetic table.
+ */
+static std::vector<std::string> columnNames(unsigned width)
+{
+	std::vector<std::string> columns = {"id"};
+	for(unsigned i = 1; i < width; i++)
+	{
+		columns.push_back("c" + std::to_string(i));
+	}
+	return columns;
+}
+
+/**
+ * Creates the bench database and loads the synthetic table.
+ */
+static bool setUp(Connector& con, const Options& options, Report& report)
+{
+	if(!con.query("DROP DATABASE IF EXISTS connector_bench") || !con.query("CREATE DATABASE connector_bench") ||
+	   !con.query("USE connector_bench") || !con.query(("CREATE TABLE bench_rows " + tableDefinition(options.width)).c_str()) ||
+	   !con.query(("CREATE TABLE bench_insert " + tableDefinition(options.width)).c_str()))
+	{
+		std::fprintf(stderr, "setup: %s\n", con.getError().c_str());
+		return false;
+	}
+
+	std::mt19937_64 rng(42);
+	BulkInserter inserter;
+	clock_type::time_point start = clock_type::now();
+	if(!inserter.open(con, "bench_rows", columnNames(options.width)))
+	{
+		std::fprintf(stderr, "setup: %s\n", inserter.getError().c_str());
+		return false;
+	}
+	for(size_t i = 0; i < options.rows; i++)
+	{
+		if(!addRow(inserter, options.width, static_cast<int64_t>(i + 1), rng))
+		{
+			std::fprintf(stderr, "setup: %s\n", inserter.getError().c_str());
+			return false;
+		}
+	}
+	if(!inserter.flush())
+	{
+		std::fprintf(stderr, "setup: %s\n", inserter.getError().c_str());
+		return false;
+	}
+	double seconds = static_cast<double>(elapsedNs(start)) / 1e9;
+	report.add("bulk_insert", "\"rows\": " + std::to_string(options.rows) + ", \"seconds\": " + std::to_string(seconds) +
+	           ", \"rows_per_sec\": " + std::to_string(static_cast<double>(options.rows) / seconds));
+	return true;
+}
+
+/**
+ * Times opening and closing fresh connections.
+ */
+static bool benchConnect(const ConnectionOptions& connection, const Options& options, Report& report)
+{
+	LatencyHistogram latency;
+	size_t count = options.iterations / 10 > 50 ? options.iterations / 10 : 50;
+	clock_type::time_point start = clock_type::now();
+	for(size_t i = 0; i < count; i++)
+	{
+		clock_type::time_point begin = clock_type::now();
+		Connector con;
+		if(!con.connect(connection))
+		{
+			std::fprintf(stderr, "connect: %s\n", con.getError().c_str());
+			return false;
+		}
+		latency.record(elapsedNs(begin));
+	}
+	report.addLatency("connect", latency.snapshot(), static_cast<double>(elapsedNs(start)) / 1e9);
+	return true;
+}
+
+/**
+ * Times primary key lookups of random rows, each into a Result.
+ */
+static bool benchPointSelect(Connector& con, const Options& options, Report& report)
+{
+	std::mt19937_64 rng(7);
+	LatencyHistogram latency;
+	Result result;
+	clock_type::time_point start = clock_type::now();
+	for(size_t i = 0; i < options.iterations; i++)
+	{
+		std::string sql = "SELECT * FROM bench_rows WHERE id = " + std::to_string(rng() % options.rows + 1);
+		clock_type::time_point begin = clock_type::now();
+		if(!con.store(sql.c_str(), result) || result.getNumRows() != 1)
+		{
+			std::fprintf(stderr, "point_select: %s\n", con.getError().c_str());
+			return false;
+		}
+		latency.record(elapsedNs(begin));
+	}
+	report.addLatency("point_select", latency.snapshot(), static_cast<double>(elapsedNs(start)) / 1e9);
+	return true;
+}
+
+/**
+ * Times streaming the whole table through a Cursor, keeping the best of three runs.
+ */
+static bool benchScan(Connector& con, Report& report)
+{
+	double best = 1e300;
+	uint64_t rows = 0, bytes = 0;
+	for(int run = 0; run < 3; run++)
+	{
+		rows = bytes = 0;
+		clock_type::time_point start = clock_type::now();
+		Cursor cursor;
+		if(!con.stream("SELECT * FROM bench_rows", cursor))
+		{
+			std::fprintf(stderr, "scan: %s\n", con.getError().c_str());
+			return false;
+		}
+		for(Row row : cursor)
+		{
+			for(unsigned i = 0; i < row.size(); i++)
+			{
+				bytes += row[i].size();
+			}
+			rows++;
+		}
+		if(!cursor.getError().empty())
+		{
+			std::fprintf(stderr, "scan: %s\n", cursor.getError().c_str());
+			return false;
+		}
+		double seconds = static_cast<double>(elapsedNs(start)) / 1e9;
+		best = seconds < best ? seconds : best;
+	}
+	report.add("scan", "\"rows\": " + std::to_string(rows) + ", \"bytes\": " + std::to_string(bytes) + ", \"seconds\": " +
+	           std::to_string(best) + ", \"rows_per_sec\": " + std::to_string(static_cast<double>(rows) / best) +
+	           ", \"mb_per_sec\": " + std::to_string(static_cast<double>(bytes) / best / 1e6));
+	return true;
+}
+
+/**
+ * Times buffering the whole table into a Result, and counts the bytes it took before and after protocol compression.
+ * The byte counts are left out when the server can not report them (FakeServer).
+ */
+static bool benchTransfer(Connector& con, Report& report)
+{
+	double best = 1e300;
+	Result result;
+	WireStats wire;
+	bool haveWire = false;
+	con.setWireAccounting(true);
+	for(int run = 0; run < 3; run++)
+	{
+		bool counting = con.resetWireStats();
+		clock_type::time_point start = clock_type::now();
+		if(!con.store("SELECT * FROM bench_rows", result))
+		{
+			std::fprintf(stderr, "transfer: %s\n", con.getError().c_str());
+			con.setWireAccounting(false);
+			return false;
+		}
+		double seconds = static_cast<double>(elapsedNs(start)) / 1e9;
+		best = seconds < best ? seconds : best;
+		haveWire = counting && con.getWireStats(wire);
+	}
+	con.setWireAccounting(false);
+	std::string members = "\"rows\": " + std::to_string(result.getNumRows()) + ", \"seconds\": " + std::to_string(best) +
+	                      ", \"rows_per_sec\": " + std::to_string(static_cast<double>(result.getNumRows()) / best);
+	if(haveWire)
+	{
+		members += ", \"raw_bytes\": " + std::to_string(wire.rawBytesReceived) + ", \"wire_bytes\": " + std::to_string(wire.wireBytesReceived) +
+		           ", \"ratio\": " + std::to_string(wire.receiveRatio()) + ", \"algorithm\": \"" + (wire.compressed ? wire.algorithm : "none") + "\"";
+	}
+	report.add("transfer", members);
+	return true;
+}
+
+/**
+ * Times Connector::query on the whole table and the getData() copy that follows it, separately.
+ */
+static bool benchGetData(Connector& con, Report& report)
+{
+	clock_type::time_point start = clock_type::now();
+	if(!con.query("SELECT * FROM bench_rows"))
+	{
+		std::fprintf(stderr, "get_data: %s\n", con.getError().c_str());
+		return false;
+	}
+	double querySeconds = static_cast<double>(elapsedNs(start)) / 1e9;
+	start = clock_type::now();
+	size_t cells = 0;
+	for(const auto& row : con.getData())
+	{
+		cells += row.size();
+	}
+	double copySeconds = static_cast<double>(elapsedNs(start)) / 1e9;
+	report.add("get_data", "\"rows\": " + std::to_string(con.getNumRows()) + ", \"cells\": " + std::to_string(cells) +
+	           ", \"query_seconds\": " + std::to_string(querySeconds) + ", \"copy_seconds\": " + std::to_string(copySeconds) +
+	           ", \"copy_ns_per_cell\": " + std::to_string(cells ? copySeconds * 1e9 / static_cast<double>(cells) : 0.0));
+	return true;
+}
+
+/**
+ * Times single row autocommit inserts.
+ */
+static bool benchInsert(Connector& con, const Options& options, Report& report)
+{
+	std::vector<std::string> columns = columnNames(options.width);
+	std::mt19937_64 rng(99);
+	LatencyHistogram latency;
+	clock_type::time_point start = clock_type::now();
+	for(size_t i = 0; i < options.iterations; i++)
+	{
+		std::string sql = "INSERT INTO bench_insert VALUES (" + std::to_string(i + 1);
+		for(unsigned c = 1; c < options.width; c++)
+		{
+			switch((c - 1) % 3)
+			{
+				case 0: sql += "," + std::to_string(static_cast<int32_t>(rng())); break;
+				case 1: sql += "," + std::to_string(static_cast<double>(rng() % 10000000) / 100.0); break;
+				default: sql += ",'value-" + std::to_string(rng() % 1000000000) + "'"; break;
+			}
+		}
+		sql += ")";
+		clock_type::time_point begin = clock_type::now();
+		if(!con.query(sql.c_str()))
+		{
+			std::fprintf(stderr, "insert: %s\n", con.getError().c_str());
+			return false;
+		}
+		latency.record(elapsedNs(begin));
+	}
+	report.addLatency("insert", latency.snapshot(), static_cast<double>(elapsedNs(start)) / 1e9);
+	return true;
+}
+
+/**
+ * Parses the command line.
+ * @return If every option was understood or not.
+ */
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if(arg == "--fake")
+		{
+			options.fake = true;
+			continue;
+		}
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if(!value)
+		{
+			std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+			return false;
+		}
+		if(arg == "--mysqld") options.mysqld = value;
+		else if(arg == "--install-db") options.installDb = value;
+		else if(arg == "--socket") options.socket = value;
+		else if(arg == "--user") options.user = value;
+		else if(arg == "--pass") options.pass = value;
+		else if(arg == "--rows") options.rows = std::strtoull(value, nullptr, 10);
+		else if(arg == "--width") options.width = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		else if(arg == "--iterations") options.iterations = std::strtoull(value, nullptr, 10);
+		else if(arg == "--out") options.out = value;
+		else if(arg == "--zstd-level") options.zstdLevel = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		else if(arg == "--compress")
+		{
+			std::string algorithm = value;
+			if(algorithm == "none") options.compression = Compression::NONE;
+			else if(algorithm == "zlib") options.compression = Compression::ZLIB;
+			else if(algorithm == "zstd") options.compression = Compression::ZSTD;
+			else
+			{
+				std::fprintf(stderr, "--compress takes none, zlib or zstd\n");
+				return false;
+			}
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			return false;
+		}
+		i++;
+	}
+	if(options.rows == 0 || options.width == 0)
+	{
+		std::fprintf(stderr, "--rows and --width must be at least 1\n");
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if(!parseOptions(argc, argv, options))
+	{
+		return 2;
+	}
+
+	ConnectionOptions connection;
+	connection.user = options.user;
+	connection.pass = options.pass;
+	connection.unix_socket = options.socket;
+	ServerFixture server;
+	FakeServer fake;
+	if(options.fake)
+	{
+		connection.unix_socket = "/tmp/connector-bench-fake-" + std::to_string(getpid()) + ".sock";
+		if(!loadFakeServer(fake, options) || !fake.start(connection.unix_socket))
+		{
+			std::fprintf(stderr, "%s\n", fake.getError().c_str());
+			return 1;
+		}
+	}
+	else if(options.socket.empty() && !server.start(options, connection))
+	{
+		std::fprintf(stderr, "%s\n", server.getError().c_str());
+		return 1;
+	}
+
+	connection.compression = options.compression;
+	connection.compression_level = options.zstdLevel;
+	Connector con;
+	if(!con.connect(connection))
+	{
+		std::fprintf(stderr, "connect: %s\n", con.getError().c_str());
+		return 1;
+	}
+	std::string version = mysql_get_server_info(con.getMYSQL_Ptr());
+
+	Report report;
+	bool ok = setUp(con, options, report);
+	connection.db = "connector_bench";
+	ok = ok && benchConnect(connection, options, report);
+	ok = ok && benchPointSelect(con, options, report);
+	ok = ok && benchScan(con, report);
+	ok = ok && benchTransfer(con, report);
+	ok = ok && benchGetData(con, report);
+	ok = ok && benchInsert(con, options, report);
+	con.query("DROP DATABASE IF EXISTS connector_bench");
+
+	std::string json = report.render(options, version, ok);
+	if(options.out.empty())
+	{
+		std::fputs(json.c_str(), stdout);
+	}
+	else
+	{
+		std::ofstream(options.out) << json;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,962 @@
+/**
+ *
+ * @file fake_server.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector fake server source file
+ */
+
+#include "fake_server.h"
+
+#include <charconv> /**Library needed to use std::from_chars*/
+#include <cstdio> /**Library needed to use std::sscanf*/
+#include <cstdlib> /**Library needed to use std::strtod*/
+#include <cstring> /**Library needed to use std::memcpy and std::strerror*/
+#include <cerrno> /**Library needed to use errno*/
+#include <random> /**Library needed to use std::mt19937*/
+
+#include <sys/socket.h> /**POSIX header needed to use socket, bind, listen and accept*/
+#include <sys/un.h> /**POSIX header needed to use sockaddr_un*/
+#include <unistd.h> /**POSIX header needed to use close and unlink*/
+
+namespace
+{
+	/**
+	 * Capability flags the server advertises.
+	 */
+	const uint32_t CAP_LONG_PASSWORD = 0x00000001;
+	const uint32_t CAP_FOUND_ROWS = 0x00000002;
+	const uint32_t CAP_LONG_FLAG = 0x00000004;
+	const uint32_t CAP_CONNECT_WITH_DB = 0x00000008;
+	const uint32_t CAP_PROTOCOL_41 = 0x00000200;
+	const uint32_t CAP_SSL = 0x00000800;
+	const uint32_t CAP_TRANSACTIONS = 0x00002000;
+	const uint32_t CAP_SECURE_CONNECTION = 0x00008000;
+	const uint32_t CAP_MULTI_STATEMENTS = 0x00010000;
+	const uint32_t CAP_MULTI_RESULTS = 0x00020000;
+	const uint32_t CAP_PS_MULTI_RESULTS = 0x00040000;
+	const uint32_t CAP_PLUGIN_AUTH = 0x00080000;
+	const uint32_t CAP_PLUGIN_AUTH_LENENC_DATA = 0x00200000;
+	const uint32_t CAP_DEPRECATE_EOF = 0x01000000;
+	const uint32_t SERVER_CAPABILITIES = CAP_LONG_PASSWORD | CAP_FOUND_ROWS | CAP_LONG_FLAG | CAP_CONNECT_WITH_DB | CAP_PROTOCOL_41 |
+	                                     CAP_TRANSACTIONS | CAP_SECURE_CONNECTION | CAP_MULTI_STATEMENTS | CAP_MULTI_RESULTS |
+	                                     CAP_PS_MULTI_RESULTS | CAP_PLUGIN_AUTH | CAP_PLUGIN_AUTH_LENENC_DATA | CAP_DEPRECATE_EOF;
+
+	/**
+	 * Command bytes.
+	 */
+	enum Command : uint8_t
+	{
+		COM_QUIT_BYTE = 0x01,
+		COM_INIT_DB_BYTE = 0x02,
+		COM_QUERY_BYTE = 0x03,
+		COM_PING_BYTE = 0x0e,
+		COM_STMT_PREPARE_BYTE = 0x16,
+		COM_STMT_EXECUTE_BYTE = 0x17,
+		COM_STMT_SEND_LONG_DATA_BYTE = 0x18,
+		COM_STMT_CLOSE_BYTE = 0x19,
+		COM_STMT_RESET_BYTE = 0x1a,
+		COM_SET_OPTION_BYTE = 0x1b,
+		COM_RESET_CONNECTION_BYTE = 0x1f
+	};
+
+	const char SERVER_VERSION[] = "8.0.36-connector-fake";
+	const uint16_t STATUS_AUTOCOMMIT = 0x0002;
+	const uint8_t CHARSET_UTF8MB4 = 255;
+	const uint8_t CHARSET_BINARY = 63;
+	const size_t MAX_PAYLOAD = 0xFFFFFF;
+
+	/**
+	 * Appends an integer in little endian order.
+	 */
+	void putInt(string& out, uint64_t value, int bytes)
+	{
+		for(int i = 0; i < bytes; i++)
+		{
+			out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	/**
+	 * Appends a length encoded integer.
+	 */
+	void putLenenc(string& out, uint64_t value)
+	{
+		if(value < 251)
+		{
+			putInt(out, value, 1);
+		}
+		else if(value < 0x10000)
+		{
+			out.push_back(static_cast<char>(0xFC));
+			putInt(out, value, 2);
+		}
+		else if(value < 0x1000000)
+		{
+			out.push_back(static_cast<char>(0xFD));
+			putInt(out, value, 3);
+		}
+		else
+		{
+			out.push_back(static_cast<char>(0xFE));
+			putInt(out, value, 8);
+		}
+	}
+
+	/**
+	 * Appends a length encoded string.
+	 */
+	void putLenencString(string& out, string_view value)
+	{
+		putLenenc(out, value.size());
+		out.append(value.data(), value.size());
+	}
+
+	/**
+	 * Reads a little endian integer.
+	 */
+	uint64_t getInt(const string& in, size_t offset, int bytes)
+	{
+		uint64_t value = 0;
+		for(int i = 0; i < bytes && offset + i < in.size(); i++)
+		{
+			value |= uint64_t(static_cast<uint8_t>(in[offset + i])) << (8 * i);
+		}
+		return value;
+	}
+
+	/**
+	 * Frames payloads into packets with consecutive sequence ids, splitting payloads of 16MB or more.
+	 */
+	class PacketWriter
+	{
+		string _bytes; /**<Framed packets.*/
+		uint8_t _seq; /**<Sequence id of the next packet.*/
+
+		public:
+		explicit PacketWriter(uint8_t seq) : _seq(seq) {}
+
+		void packet(string_view payload)
+		{
+			while(true)
+			{
+				size_t chunk = payload.size() < MAX_PAYLOAD ? payload.size() : MAX_PAYLOAD;
+				putInt(_bytes, chunk, 3);
+				_bytes.push_back(static_cast<char>(_seq++));
+				_bytes.append(payload.data(), chunk);
+				payload.remove_prefix(chunk);
+				if(chunk < MAX_PAYLOAD)
+				{
+					break;
+				}
+			}
+		}
+
+		inline string& bytes() {return _bytes;}
+	};
+
+	/**
+	 * OK packet payload.
+	 */
+	string okPayload(uint64_t affectedRows, uint8_t header = 0x00)
+	{
+		string payload(1, static_cast<char>(header));
+		putLenenc(payload, affectedRows);
+		putLenenc(payload, 0);
+		putInt(payload, STATUS_AUTOCOMMIT, 2);
+		putInt(payload, 0, 2);
+		return payload;
+	}
+
+	/**
+	 * Payload closing a list of columns or rows: an EOF packet, or an OK packet with the EOF header for clients with
+	 * CLIENT_DEPRECATE_EOF.
+	 */
+	string endPayload(bool deprecateEof)
+	{
+		if(deprecateEof)
+		{
+			return okPayload(0, 0xFE);
+		}
+		string payload(1, static_cast<char>(0xFE));
+		putInt(payload, 0, 2);
+		putInt(payload, STATUS_AUTOCOMMIT, 2);
+		return payload;
+	}
+
+	/**
+	 * ERR packet payload.
+	 */
+	string errorPayload(uint16_t code, const string& message)
+	{
+		string payload(1, static_cast<char>(0xFF));
+		putInt(payload, code, 2);
+		payload += "#HY000";
+		payload += message;
+		return payload;
+	}
+
+	/**
+	 * Checks if a column type is sent as text with a character set.
+	 */
+	bool isTextType(enum_field_types type)
+	{
+		return type == MYSQL_TYPE_VARCHAR || type == MYSQL_TYPE_VAR_STRING || type == MYSQL_TYPE_STRING ||
+		       type == MYSQL_TYPE_ENUM || type == MYSQL_TYPE_SET || type == MYSQL_TYPE_JSON;
+	}
+
+	/**
+	 * Column definition payload.
+	 */
+	string definitionPayload(const FakeServer::Column& column)
+	{
+		uint32_t length = 255;
+		uint16_t flags = 0;
+		uint8_t decimals = 0;
+		switch(column.type)
+		{
+			case MYSQL_TYPE_TINY: length = 4; break;
+			case MYSQL_TYPE_SHORT: length = 6; break;
+			case MYSQL_TYPE_INT24: length = 9; break;
+			case MYSQL_TYPE_LONG: length = 11; break;
+			case MYSQL_TYPE_LONGLONG: length = 20; break;
+			case MYSQL_TYPE_YEAR: length = 4; break;
+			case MYSQL_TYPE_FLOAT: length = 12; decimals = 31; break;
+			case MYSQL_TYPE_DOUBLE: length = 22; decimals = 31; break;
+			case MYSQL_TYPE_DECIMAL: case MYSQL_TYPE_NEWDECIMAL: length = 65; break;
+			case MYSQL_TYPE_DATE: length = 10; break;
+			case MYSQL_TYPE_TIME: length = 10; break;
+			case MYSQL_TYPE_DATETIME: case MYSQL_TYPE_TIMESTAMP: length = 19; break;
+			case MYSQL_TYPE_TINY_BLOB: case MYSQL_TYPE_BLOB: case MYSQL_TYPE_MEDIUM_BLOB: case MYSQL_TYPE_LONG_BLOB: length = 65535; break;
+			default: length = 1020; break;
+		}
+		if(column.type == MYSQL_TYPE_TINY || column.type == MYSQL_TYPE_SHORT || column.type == MYSQL_TYPE_INT24 ||
+		   column.type == MYSQL_TYPE_LONG || column.type == MYSQL_TYPE_LONGLONG || column.type == MYSQL_TYPE_YEAR ||
+		   column.type == MYSQL_TYPE_FLOAT || column.type == MYSQL_TYPE_DOUBLE || column.type == MYSQL_TYPE_DECIMAL ||
+		   column.type == MYSQL_TYPE_NEWDECIMAL)
+		{
+			flags |= NUM_FLAG;
+		}
+		if(column.isUnsigned)
+		{
+			flags |= UNSIGNED_FLAG;
+		}
+		if(!isTextType(column.type))
+		{
+			flags |= BINARY_FLAG;
+		}
+
+		string payload;
+		putLenencString(payload, "def");
+		putLenencString(payload, "");
+		putLenencString(payload, "");
+		putLenencString(payload, "");
+		putLenencString(payload, column.name);
+		putLenencString(payload, column.name);
+		putLenenc(payload, 0x0C);
+		putInt(payload, isTextType(column.type) ? CHARSET_UTF8MB4 : CHARSET_BINARY, 2);
+		putInt(payload, length, 4);
+		putInt(payload, static_cast<uint8_t>(column.type), 1);
+		putInt(payload, flags, 2);
+		putInt(payload, decimals, 1);
+		putInt(payload, 0, 2);
+		return payload;
+	}
+
+	/**
+	 * Reads the microseconds after the point of a time value, 0 when there is none.
+	 */
+	uint32_t parseMicroseconds(const string& text)
+	{
+		size_t point = text.find('.');
+		if(point == string::npos)
+		{
+			return 0;
+		}
+		uint32_t value = 0;
+		size_t digits = 0;
+		for(size_t i = point + 1; i < text.size() && digits < 6 && text[i] >= '0' && text[i] <= '9'; i++, digits++)
+		{
+			value = value * 10 + static_cast<uint32_t>(text[i] - '0');
+		}
+		for(; digits < 6; digits++)
+		{
+			value *= 10;
+		}
+		return value;
+	}
+
+	/**
+	 * Appends the binary protocol form of a non-NULL cell.
+	 * @return If the text was a valid value of the column type.
+	 */
+	bool putBinaryCell(string& out, const FakeServer::Column& column, const string& text)
+	{
+		int bytes = 0;
+		switch(column.type)
+		{
+			case MYSQL_TYPE_TINY: bytes = 1; break;
+			case MYSQL_TYPE_SHORT: case MYSQL_TYPE_YEAR: bytes = 2; break;
+			case MYSQL_TYPE_INT24: case MYSQL_TYPE_LONG: bytes = 4; break;
+			case MYSQL_TYPE_LONGLONG: bytes = 8; break;
+			default: break;
+		}
+		if(bytes)
+		{
+			uint64_t value = 0;
+			std::from_chars_result parsed;
+			if(column.isUnsigned)
+			{
+				parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+			}
+			else
+			{
+				int64_t signedValue = 0;
+				parsed = std::from_chars(text.data(), text.data() + text.size(), signedValue);
+				value = static_cast<uint64_t>(signedValue);
+			}
+			putInt(out, value, bytes);
+			return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+		}
+
+		if(column.type == MYSQL_TYPE_FLOAT || column.type == MYSQL_TYPE_DOUBLE)
+		{
+			char* end = nullptr;
+			double value = std::strtod(text.c_str(), &end);
+			char raw[8];
+			if(column.type == MYSQL_TYPE_FLOAT)
+			{
+				float narrow = static_cast<float>(value);
+				std::memcpy(raw, &narrow, 4);
+				out.append(raw, 4);
+			}
+			else
+			{
+				std::memcpy(raw, &value, 8);
+				out.append(raw, 8);
+			}
+			return end == text.c_str() + text.size();
+		}
+
+		if(column.type == MYSQL_TYPE_DATE || column.type == MYSQL_TYPE_DATETIME || column.type == MYSQL_TYPE_TIMESTAMP)
+		{
+			int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+			int fields = std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second);
+			if(fields < 3)
+			{
+				return false;
+			}
+			uint32_t micro = column.type == MYSQL_TYPE_DATE ? 0 : parseMicroseconds(text);
+			if(column.type == MYSQL_TYPE_DATE)
+			{
+				hour = minute = second = 0;
+			}
+			uint8_t length = micro ? 11 : (hour || minute || second) ? 7 : (year || month || day) ? 4 : 0;
+			putInt(out, length, 1);
+			if(length >= 4)
+			{
+				putInt(out, static_cast<uint64_t>(year), 2);
+				putInt(out, static_cast<uint64_t>(month), 1);
+				putInt(out, static_cast<uint64_t>(day), 1);
+			}
+			if(length >= 7)
+			{
+				putInt(out, static_cast<uint64_t>(hour), 1);
+				putInt(out, static_cast<uint64_t>(minute), 1);
+				putInt(out, static_cast<uint64_t>(second), 1);
+			}
+			if(length == 11)
+			{
+				putInt(out, micro, 4);
+			}
+			return true;
+		}
+
+		if(column.type == MYSQL_TYPE_TIME)
+		{
+			bool negative = !text.empty() && text[0] == '-';
+			int hours = 0, minute = 0, second = 0;
+			if(std::sscanf(text.c_str() + negative, "%d:%d:%d", &hours, &minute, &second) != 3)
+			{
+				return false;
+			}
+			uint32_t micro = parseMicroseconds(text);
+			uint8_t length = micro ? 12 : (hours || minute || second) ? 8 : 0;
+			putInt(out, length, 1);
+			if(length)
+			{
+				putInt(out, negative, 1);
+				putInt(out, static_cast<uint64_t>(hours / 24), 4);
+				putInt(out, static_cast<uint64_t>(hours % 24), 1);
+				putInt(out, static_cast<uint64_t>(minute), 1);
+				putInt(out, static_cast<uint64_t>(second), 1);
+			}
+			if(length == 12)
+			{
+				putInt(out, micro, 4);
+			}
+			return true;
+		}
+
+		putLenencString(out, text);
+		return true;
+	}
+
+	/**
+	 * Counts the ? placeholders of a statement, skipping quoted text.
+	 */
+	uint16_t countParameters(string_view sql)
+	{
+		uint16_t count = 0;
+		char quote = 0;
+		for(size_t i = 0; i < sql.size(); i++)
+		{
+			char c = sql[i];
+			if(quote)
+			{
+				if(c == '\\' && quote != '`')
+				{
+					i++;
+				}
+				else if(c == quote)
+				{
+					quote = 0;
+				}
+			}
+			else if(c == '\'' || c == '"' || c == '`')
+			{
+				quote = c;
+			}
+			else if(c == '?')
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Writes every byte to a socket.
+	 */
+	bool sendAll(int fd, const char* data, size_t length)
+	{
+		while(length)
+		{
+			ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+			if(n < 0)
+			{
+				if(errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			data += n;
+			length -= static_cast<size_t>(n);
+		}
+		return true;
+	}
+
+	/**
+	 * Reads exactly length bytes from a socket.
+	 */
+	bool receiveAll(int fd, char* data, size_t length)
+	{
+		while(length)
+		{
+			ssize_t n = ::recv(fd, data, length, 0);
+			if(n <= 0)
+			{
+				if(n < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			data += n;
+			length -= static_cast<size_t>(n);
+		}
+		return true;
+	}
+
+	/**
+	 * Reads one logical packet, joining the pieces of payloads of 16MB or more.
+	 */
+	bool readPacket(int fd, string& payload)
+	{
+		payload.clear();
+		while(true)
+		{
+			unsigned char header[4];
+			if(!receiveAll(fd, reinterpret_cast<char*>(header), 4))
+			{
+				return false;
+			}
+			size_t length = header[0] | (header[1] << 8) | (header[2] << 16);
+			size_t offset = payload.size();
+			payload.resize(offset + length);
+			if(length && !receiveAll(fd, &payload[offset], length))
+			{
+				return false;
+			}
+			if(length < MAX_PAYLOAD)
+			{
+				return true;
+			}
+		}
+	}
+
+	/**
+	 * Sends payloads as one response starting at sequence id seq.
+	 */
+	bool sendPackets(int fd, uint8_t seq, std::initializer_list<string_view> payloads)
+	{
+		PacketWriter writer(seq);
+		for(string_view payload : payloads)
+		{
+			writer.packet(payload);
+		}
+		return sendAll(fd, writer.bytes().data(), writer.bytes().size());
+	}
+}
+
+/**
+ * Registers the result set a statement is answered with, over both protocols. Must be called before start().
+ * @param sql Statement text, or its beginning when prefix is true. It is compared byte for byte.
+ * @param result Columns and rows to answer with.
+ * @param prefix If every statement starting with sql gets this result. Exact matches are tried first, then prefixes in the order they were registered.
+ * @return If the result was registered or not; fails when a row has the wrong number of cells or a cell is not valid for its column type.
+ */
+bool FakeServer::setResult(const string& sql, const ResultSet& result, bool prefix)
+{
+	std::shared_ptr<Canned> canned = std::make_shared<Canned>();
+	canned->sql = sql;
+	canned->num_columns = static_cast<unsigned int>(result.columns.size());
+	for(const Column& column : result.columns)
+	{
+		canned->definitions.push_back(definitionPayload(column));
+	}
+
+	size_t bitmapBytes = (result.columns.size() + 7 + 2) / 8;
+	for(int deprecateEof = 0; deprecateEof < 2; deprecateEof++)
+	{
+		PacketWriter text(1), binary(1);
+		if(result.columns.empty())
+		{
+			text.packet(okPayload(result.affectedRows));
+			binary.packet(okPayload(result.affectedRows));
+		}
+		else
+		{
+			string count;
+			putLenenc(count, result.columns.size());
+			for(PacketWriter* writer : {&text, &binary})
+			{
+				writer->packet(count);
+				for(const string& definition : canned->definitions)
+				{
+					writer->packet(definition);
+				}
+				if(!deprecateEof)
+				{
+					writer->packet(endPayload(false));
+				}
+			}
+
+			string textRow, binaryRow;
+			for(size_t r = 0; r < result.rows.size(); r++)
+			{
+				const vector<std::optional<string> >& row = result.rows[r];
+				if(row.size() != result.columns.size())
+				{
+					_error = "Row " + std::to_string(r) + " has " + std::to_string(row.size()) + " cells for " + std::to_string(result.columns.size()) + " columns.";
+					return false;
+				}
+				textRow.clear();
+				binaryRow.assign(1 + bitmapBytes, '\0');
+				for(size_t c = 0; c < row.size(); c++)
+				{
+					if(!row[c])
+					{
+						textRow.push_back(static_cast<char>(0xFB));
+						binaryRow[1 + (c + 2) / 8] |= static_cast<char>(1 << ((c + 2) % 8));
+						continue;
+					}
+					putLenencString(textRow, *row[c]);
+					if(!putBinaryCell(binaryRow, result.columns[c], *row[c]))
+					{
+						_error = "Row " + std::to_string(r) + " column " + result.columns[c].name + " value '" + *row[c] + "' does not fit its type.";
+						return false;
+					}
+				}
+				text.packet(textRow);
+				binary.packet(binaryRow);
+			}
+			text.packet(endPayload(deprecateEof));
+			binary.packet(endPayload(deprecateEof));
+		}
+		canned->text[deprecateEof] = std::move(text.bytes());
+		canned->binary[deprecateEof] = std::move(binary.bytes());
+	}
+
+	if(prefix)
+	{
+		_prefixes.push_back(std::move(canned));
+	}
+	else
+	{
+		_exact[sql] = std::move(canned);
+	}
+	return true;
+}
+
+/**
+ * Finds the result registered for a statement.
+ * @param sql Statement text.
+ * @return The result, nullptr when none matches.
+ */
+const FakeServer::Canned* FakeServer::find(string_view sql) const
+{
+	auto exact = _exact.find(string(sql));
+	if(exact != _exact.end())
+	{
+		return exact->second.get();
+	}
+	for(const std::shared_ptr<const Canned>& canned : _prefixes)
+	{
+		if(sql.substr(0, canned->sql.size()) == canned->sql)
+		{
+			return canned.get();
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Starts listening on a unix socket. A stale socket file at the path is replaced.
+ * @param socketPath Path of the socket, passed to clients as their unix socket.
+ * @return If the server is listening or not.
+ */
+bool FakeServer::start(const string& socketPath)
+{
+	stop();
+	_error.clear();
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if(socketPath.size() >= sizeof(address.sun_path))
+	{
+		_error = "Socket path " + socketPath + " is too long.";
+		return false;
+	}
+	std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+	_listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if(_listener < 0)
+	{
+		_error = string("Could not create a socket: ") + std::strerror(errno);
+		return false;
+	}
+	::unlink(socketPath.c_str());
+	if(::bind(_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(_listener, 128) < 0)
+	{
+		_error = "Could not listen on " + socketPath + ": " + std::strerror(errno);
+		::close(_listener);
+		_listener = -1;
+		return false;
+	}
+	_socketPath = socketPath;
+	_stopping = false;
+	_acceptor = std::thread(&FakeServer::acceptLoop, this);
+	return true;
+}
+
+/**
+ * Accepts connections until the server stops, starting a session thread for each.
+ */
+void FakeServer::acceptLoop()
+{
+	while(!_stopping)
+	{
+		int fd = ::accept(_listener, nullptr, nullptr);
+		if(fd < 0)
+		{
+			if(errno == EINTR && !_stopping)
+			{
+				continue;
+			}
+			break;
+		}
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(_stopping)
+		{
+			::close(fd);
+			break;
+		}
+		reapSessions();
+		_clients.push_back(fd);
+		_sessions.emplace_back(&FakeServer::session, this, fd);
+	}
+}
+
+/**
+ * Joins the session threads whose connection has closed, so a benchmark that keeps reconnecting doesn't pile up
+ * threads until stop(). Must be called with _mutex held.
+ */
+void FakeServer::reapSessions()
+{
+	for(std::thread::id id : _finished)
+	{
+		for(size_t i = 0; i < _sessions.size(); i++)
+		{
+			if(_sessions[i].get_id() == id)
+			{
+				// The thread only has to return from session(), it no longer takes the mutex.
+				_sessions[i].join();
+				_sessions[i] = std::move(_sessions.back());
+				_sessions.pop_back();
+				break;
+			}
+		}
+	}
+	_finished.clear();
+}
+
+/**
+ * Serves one connection: the handshake, then commands until the client quits or the server stops.
+ * @param fd Socket of the connection.
+ */
+void FakeServer::session(int fd)
+{
+	uint32_t connectionId = ++_connectionIds;
+	std::mt19937 rng(connectionId);
+	string scramble;
+	for(int i = 0; i < 20; i++)
+	{
+		scramble.push_back(static_cast<char>(33 + rng() % 94));
+	}
+
+	string greeting(1, static_cast<char>(10));
+	greeting.append(SERVER_VERSION, sizeof(SERVER_VERSION));
+	putInt(greeting, connectionId, 4);
+	greeting.append(scramble, 0, 8);
+	greeting.push_back('\0');
+	putInt(greeting, SERVER_CAPABILITIES & 0xFFFF, 2);
+	putInt(greeting, CHARSET_UTF8MB4, 1);
+	putInt(greeting, STATUS_AUTOCOMMIT, 2);
+	putInt(greeting, SERVER_CAPABILITIES >> 16, 2);
+	putInt(greeting, scramble.size() + 1, 1);
+	greeting.append(10, '\0');
+	greeting.append(scramble, 8, string::npos);
+	greeting.push_back('\0');
+	greeting.append("mysql_native_password", sizeof("mysql_native_password"));
+
+	string packet;
+	bool open = sendPackets(fd, 0, {greeting}) && readPacket(fd, packet) && packet.size() >= 32;
+	uint32_t capabilities = open ? static_cast<uint32_t>(getInt(packet, 0, 4)) : 0;
+	if(open && (capabilities & CAP_SSL))
+	{
+		sendPackets(fd, 2, {errorPayload(1045, "FakeServer does not support TLS, connect with SSL disabled.")});
+		open = false;
+	}
+	if(open)
+	{
+		// Handshake response: capabilities, max packet, charset, 23 reserved bytes, user, auth response, database, plugin.
+		size_t offset = 32;
+		offset = packet.find('\0', offset);
+		offset = offset == string::npos ? packet.size() : offset + 1;
+		uint64_t authLength = 0;
+		if(capabilities & CAP_PLUGIN_AUTH_LENENC_DATA)
+		{
+			uint8_t first = static_cast<uint8_t>(offset < packet.size() ? packet[offset] : 0);
+			int bytes = first == 0xFC ? 2 : first == 0xFD ? 3 : first == 0xFE ? 8 : 0;
+			authLength = bytes ? getInt(packet, offset + 1, bytes) : first;
+			offset += 1 + bytes;
+		}
+		else
+		{
+			authLength = static_cast<uint8_t>(offset < packet.size() ? packet[offset] : 0);
+			offset++;
+		}
+		offset += authLength;
+		if((capabilities & CAP_CONNECT_WITH_DB) && offset < packet.size())
+		{
+			size_t end = packet.find('\0', offset);
+			offset = end == string::npos ? packet.size() : end + 1;
+		}
+		string plugin;
+		if((capabilities & CAP_PLUGIN_AUTH) && offset < packet.size())
+		{
+			plugin.assign(packet.c_str() + offset);
+		}
+		// Credentials are not checked. caching_sha2_password clients expect "fast auth success" before the OK.
+		if(plugin == "caching_sha2_password" && authLength)
+		{
+			open = sendPackets(fd, 2, {string("\x01\x03", 2), okPayload(0)});
+		}
+		else
+		{
+			open = sendPackets(fd, 2, {okPayload(0)});
+		}
+	}
+
+	bool deprecateEof = (capabilities & CAP_DEPRECATE_EOF) != 0;
+	std::unordered_map<uint32_t, const Canned*> statements;
+	uint32_t nextStatement = 0;
+	while(open && readPacket(fd, packet) && !packet.empty())
+	{
+		switch(static_cast<uint8_t>(packet[0]))
+		{
+			case COM_QUERY_BYTE:
+			{
+				_queries.fetch_add(1, std::memory_order_relaxed);
+				const Canned* canned = find(string_view(packet).substr(1));
+				if(canned)
+				{
+					const string& response = canned->text[deprecateEof];
+					open = sendAll(fd, response.data(), response.size());
+				}
+				else
+				{
+					open = sendPackets(fd, 1, {okPayload(0)});
+				}
+				break;
+			}
+			case COM_STMT_PREPARE_BYTE:
+			{
+				string_view sql = string_view(packet).substr(1);
+				const Canned* canned = find(sql);
+				uint16_t params = countParameters(sql);
+				uint32_t id = ++nextStatement;
+				statements[id] = canned;
+
+				string prepared(1, '\0');
+				putInt(prepared, id, 4);
+				putInt(prepared, canned ? canned->num_columns : 0, 2);
+				putInt(prepared, params, 2);
+				prepared.push_back('\0');
+				putInt(prepared, 0, 2);
+				PacketWriter writer(1);
+				writer.packet(prepared);
+				if(params)
+				{
+					string parameter = definitionPayload(Column{"?", MYSQL_TYPE_VAR_STRING, false});
+					for(uint16_t i = 0; i < params; i++)
+					{
+						writer.packet(parameter);
+					}
+					if(!deprecateEof)
+					{
+						writer.packet(endPayload(false));
+					}
+				}
+				if(canned && canned->num_columns)
+				{
+					for(const string& definition : canned->definitions)
+					{
+						writer.packet(definition);
+					}
+					if(!deprecateEof)
+					{
+						writer.packet(endPayload(false));
+					}
+				}
+				open = sendAll(fd, writer.bytes().data(), writer.bytes().size());
+				break;
+			}
+			case COM_STMT_EXECUTE_BYTE:
+			{
+				_queries.fetch_add(1, std::memory_order_relaxed);
+				auto statement = statements.find(static_cast<uint32_t>(getInt(packet, 1, 4)));
+				if(statement == statements.end())
+				{
+					open = sendPackets(fd, 1, {errorPayload(1243, "Unknown prepared statement handler given to mysqld_stmt_execute")});
+				}
+				else if(statement->second)
+				{
+					const string& response = statement->second->binary[deprecateEof];
+					open = sendAll(fd, response.data(), response.size());
+				}
+				else
+				{
+					open = sendPackets(fd, 1, {okPayload(0)});
+				}
+				break;
+			}
+			case COM_STMT_CLOSE_BYTE:
+				statements.erase(static_cast<uint32_t>(getInt(packet, 1, 4)));
+				break;
+			case COM_STMT_SEND_LONG_DATA_BYTE:
+				break;
+			case COM_SET_OPTION_BYTE:
+				open = sendPackets(fd, 1, {endPayload(deprecateEof)});
+				break;
+			case COM_STMT_RESET_BYTE:
+			case COM_PING_BYTE:
+			case COM_INIT_DB_BYTE:
+			case COM_RESET_CONNECTION_BYTE:
+				open = sendPackets(fd, 1, {okPayload(0)});
+				break;
+			case COM_QUIT_BYTE:
+				open = false;
+				break;
+			default:
+				open = sendPackets(fd, 1, {errorPayload(1047, "Unknown command")});
+				break;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for(size_t i = 0; i < _clients.size(); i++)
+	{
+		if(_clients[i] == fd)
+		{
+			_clients.erase(_clients.begin() + static_cast<std::ptrdiff_t>(i));
+			break;
+		}
+	}
+	_finished.push_back(std::this_thread::get_id());
+	::close(fd);
+}
+
+/**
+ * Stops accepting connections, disconnects every client and removes the socket file.
+ */
+void FakeServer::stop()
+{
+	if(_listener < 0)
+	{
+		return;
+	}
+	_stopping = true;
+	::shutdown(_listener, SHUT_RDWR);
+	if(_acceptor.joinable())
+	{
+		_acceptor.join();
+	}
+	::close(_listener);
+	_listener = -1;
+	::unlink(_socketPath.c_str());
+
+	vector<std::thread> sessions;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(int fd : _clients)
+		{
+			::shutdown(fd, SHUT_RDWR);
+		}
+		sessions.swap(_sessions);
+		_finished.clear();
+	}
+	for(std::thread& session : sessions)
+	{
+		session.join();
+	}
+}
+
+/**
+ * Basic Destructor
+ */
+FakeServer::~FakeServer()
+{
+	stop();
+}
@@ -0,0 +1,113 @@
+/**
+ *
+ * @file fake_server.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief In-process MySQL wire protocol server answering with canned result sets
+ */
+
+#ifndef FAKE_SERVER_H
+#define FAKE_SERVER_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <atomic> /**Library needed to use std::atomic*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <memory> /**Library needed to use std::shared_ptr*/
+#include <mutex> /**Library needed to use std::mutex*/
+#include <optional> /**Library needed to use std::optional*/
+#include <thread> /**Library needed to use std::thread*/
+#include <unordered_map> /**Library needed to use std::unordered_map*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+/**
+ * Stand-in for a MySQL server that lives inside the benchmark process and listens on a unix socket. It speaks just
+ * enough of the client/server protocol for the MySQL and MariaDB client libraries: the v10 handshake (any user and
+ * password is let in, whether the client answers with mysql_native_password or caching_sha2_password), COM_QUERY,
+ * COM_STMT_PREPARE/EXECUTE/CLOSE/RESET, COM_PING, COM_INIT_DB and COM_QUIT, with or without CLIENT_DEPRECATE_EOF.
+ *
+ * Queries are answered from result sets registered with setResult() before start(). Every response is encoded once
+ * when it is registered and later written to the socket as is, so a query costs a memcpy on the server side and what
+ * a benchmark measures is the client: reading packets, materializing rows, boxing cells and copying strings.
+ * Statements with no registered result (SET, INSERT, DDL...) get an OK packet.
+ */
+class FakeServer
+{
+	public:
+	/**
+	 * One column of a canned result set.
+	 */
+	struct Column
+	{
+		string name; /**<Column name.*/
+		enum_field_types type = MYSQL_TYPE_VAR_STRING; /**<Type reported to the client.*/
+		bool isUnsigned = false; /**<If an integer column is UNSIGNED.*/
+	};
+
+	/**
+	 * A canned result set. Cells are given in their text protocol form; the binary protocol form sent to prepared
+	 * statements is derived from it. std::nullopt is SQL NULL.
+	 */
+	struct ResultSet
+	{
+		vector<Column> columns; /**<Columns of the result, none for a statement without a result set.*/
+		vector<vector<std::optional<string> > > rows; /**<Cells of every row in column order.*/
+		uint64_t affectedRows = 0; /**<Affected rows reported when there are no columns.*/
+	};
+
+	private:
+	/**
+	 * A registered result set with its responses already encoded. Index 0 of each array is for clients without
+	 * CLIENT_DEPRECATE_EOF, index 1 for clients with it.
+	 */
+	struct Canned
+	{
+		string sql; /**<Statement text, or its beginning for prefix matches.*/
+		unsigned int num_columns = 0; /**<Number of columns.*/
+		vector<string> definitions; /**<Column definition payloads.*/
+		string text[2]; /**<Framed text protocol response to COM_QUERY.*/
+		string binary[2]; /**<Framed binary protocol response to COM_STMT_EXECUTE.*/
+	};
+
+	std::unordered_map<string, std::shared_ptr<const Canned> > _exact; /**<Results matched on the whole statement.*/
+	vector<std::shared_ptr<const Canned> > _prefixes; /**<Results matched on the beginning of the statement.*/
+	string _socketPath; /**<Path of the listening unix socket.*/
+	int _listener = -1; /**<Listening socket.*/
+	std::thread _acceptor; /**<Thread accepting connections.*/
+	vector<std::thread> _sessions; /**<One thread per accepted connection that has not been joined yet.*/
+	vector<std::thread::id> _finished; /**<Session threads that are done and can be joined.*/
+	vector<int> _clients; /**<Sockets of the accepted connections.*/
+	std::mutex _mutex; /**<Guards _sessions, _finished and _clients.*/
+	std::atomic<bool> _stopping{false}; /**<Boolean that stores if the server is shutting down*/
+	std::atomic<uint64_t> _queries{0}; /**<COM_QUERY and COM_STMT_EXECUTE commands answered.*/
+	std::atomic<uint32_t> _connectionIds{0}; /**<Last connection id handed out.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	const Canned* find(string_view sql) const;
+	void acceptLoop();
+	void reapSessions();
+	void session(int fd);
+
+	public:
+	FakeServer() = default;
+	FakeServer(const FakeServer& server) = delete;
+	FakeServer& operator=(const FakeServer& rhs) = delete;
+	bool setResult(const string& sql, const ResultSet& result, bool prefix = false);
+	bool start(const string& socketPath);
+	void stop();
+	inline const string& getSocketPath() const {return _socketPath;}
+	inline uint64_t getNumQueries() const {return _queries.load(std::memory_order_relaxed);}
+	inline string getError() const {return _error;}
+	~FakeServer();
+};
+
+#endif // FAKE_SERVER_H
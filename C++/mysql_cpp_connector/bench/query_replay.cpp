@@ -0,0 +1,248 @@
+/**
+ *
+ * @file query_replay.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Replays a QueryRecorder capture log against a server and reports latency percentiles as JSON
+ *
+ * Queries recorded on the same connection are replayed in order on the same replay connection, so session state
+ * (USE, SET, transactions) carries over. Each query is sent at its recorded start time divided by the speedup, or as
+ * soon as the previous one on its connection has finished when the replay falls behind. Build and run, for example:
+ *     g++ -O2 -std=c++17 -I.. $(mysql_config --cflags) query_replay.cpp ../connector.cpp ../cursor.cpp ../result.cpp \
+ *         ../columnar_result.cpp ../column_decoder.cpp ../spillable_result.cpp ../statement.cpp ../statement_cache.cpp \
+ *         ../metrics.cpp ../query_cache.cpp ../query_recorder.cpp ../runtime.cpp $(mysql_config --libs) -lpthread -o query_replay
+ *     ./query_replay --log prod.cqlog --socket /tmp/mysql.sock --user app --db shop --speedup 2
+ *
+ * Options:
+ *     --log FILE         Capture log to replay (required).
+ *     --host NAME, --port N, --socket PATH, --user NAME, --pass PASSWORD, --db NAME
+ *                        Where to replay it.
+ *     --concurrency N    Replay connections (default: one per recorded connection). Recorded connections are dealt
+ *                        out round robin, so with fewer replay connections their queries are interleaved.
+ *     --speedup F        Replay F times faster than recorded; 0 sends every query as soon as possible (default 1).
+ *     --out FILE         Write the JSON report to FILE instead of stdout.
+ *     --dump             Print the log as text instead of replaying it.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "connector.h"
+#include "metrics.h"
+#include "query_recorder.h"
+#include "result.h"
+#include "runtime.h"
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * Command line options.
+ */
+struct Options
+{
+	std::string log; /**<Capture log to replay.*/
+	ConnectionOptions connection; /**<Server to replay against.*/
+	size_t concurrency = 0; /**<Replay connections, 0 for one per recorded connection.*/
+	double speedup = 1.0; /**<How much faster than recorded to replay, 0 for as fast as possible.*/
+	std::string out; /**<File the report is written to, empty for stdout.*/
+	bool dump = false; /**<If the log is printed instead of replayed.*/
+};
+
+/**
+ * Formats the percentiles of a histogram as JSON members.
+ */
+static std::string latencyJson(const HistogramSnapshot& latency)
+{
+	char buffer[384];
+	std::snprintf(buffer, sizeof(buffer),
+	              "{\"count\": %llu, \"mean_ns\": %llu, \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}",
+	              static_cast<unsigned long long>(latency.count), static_cast<unsigned long long>(latency.count ? latency.sum / latency.count : 0),
+	              static_cast<unsigned long long>(latency.percentile(50)), static_cast<unsigned long long>(latency.percentile(90)),
+	              static_cast<unsigned long long>(latency.percentile(99)), static_cast<unsigned long long>(latency.percentile(99.9)),
+	              static_cast<unsigned long long>(latency.max));
+	return buffer;
+}
+
+/**
+ * Parses the command line.
+ * @return If every option was understood or not.
+ */
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if(arg == "--dump")
+		{
+			options.dump = true;
+			continue;
+		}
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if(!value)
+		{
+			std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+			return false;
+		}
+		if(arg == "--log") options.log = value;
+		else if(arg == "--host") options.connection.host = value;
+		else if(arg == "--port") options.connection.port = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		else if(arg == "--socket") options.connection.unix_socket = value;
+		else if(arg == "--user") options.connection.user = value;
+		else if(arg == "--pass") options.connection.pass = value;
+		else if(arg == "--db") options.connection.db = value;
+		else if(arg == "--concurrency") options.concurrency = std::strtoull(value, nullptr, 10);
+		else if(arg == "--speedup") options.speedup = std::strtod(value, nullptr);
+		else if(arg == "--out") options.out = value;
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			return false;
+		}
+		i++;
+	}
+	if(options.log.empty())
+	{
+		std::fprintf(stderr, "--log is required\n");
+		return false;
+	}
+	if(options.speedup < 0)
+	{
+		std::fprintf(stderr, "--speedup must not be negative\n");
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if(!parseOptions(argc, argv, options))
+	{
+		return 2;
+	}
+
+	QueryLogReader reader;
+	if(!reader.open(options.log))
+	{
+		std::fprintf(stderr, "%s\n", reader.getError().c_str());
+		return 1;
+	}
+	std::vector<RecordedQuery> queries;
+	RecordedQuery query;
+	while(reader.next(query))
+	{
+		queries.push_back(std::move(query));
+	}
+	if(!reader.getError().empty())
+	{
+		std::fprintf(stderr, "%s (replaying the %zu queries before it)\n", reader.getError().c_str(), queries.size());
+	}
+	std::stable_sort(queries.begin(), queries.end(), [](const RecordedQuery& a, const RecordedQuery& b) {return a.start < b.start;});
+
+	if(options.dump)
+	{
+		for(const RecordedQuery& recorded : queries)
+		{
+			std::printf("%12.3f ms  conn %-8llu %10.1f us  %s  %s\n", static_cast<double>(recorded.start) / 1e6,
+			            static_cast<unsigned long long>(recorded.connectionId), static_cast<double>(recorded.duration) / 1e3,
+			            recorded.ok ? "ok " : "ERR", recorded.sql.c_str());
+		}
+		return 0;
+	}
+
+	// Deal the recorded connections out to the replay connections in order of first appearance.
+	std::unordered_map<uint64_t, size_t> sessions;
+	for(const RecordedQuery& recorded : queries)
+	{
+		sessions.emplace(recorded.connectionId, sessions.size());
+	}
+	size_t concurrency = options.concurrency ? options.concurrency : std::max<size_t>(sessions.size(), 1);
+	std::vector<std::vector<const RecordedQuery*> > plans(concurrency);
+	LatencyHistogram recordedLatency;
+	uint64_t recordedErrors = 0;
+	for(const RecordedQuery& recorded : queries)
+	{
+		plans[sessions[recorded.connectionId] % concurrency].push_back(&recorded);
+		recordedLatency.record(recorded.duration);
+		recordedErrors += !recorded.ok;
+	}
+
+	std::vector<Connector> connectors(concurrency);
+	for(Connector& con : connectors)
+	{
+		if(!con.connect(options.connection))
+		{
+			std::fprintf(stderr, "connect: %s\n", con.getError().c_str());
+			return 1;
+		}
+	}
+
+	LatencyHistogram latency, lag;
+	std::atomic<uint64_t> errors{0};
+	clock_type::time_point origin = clock_type::now() + std::chrono::milliseconds(100);
+	std::vector<std::thread> workers;
+	for(size_t w = 0; w < concurrency; w++)
+	{
+		workers.emplace_back([&, w]()
+		{
+			ThreadScope scope;
+			Connector& con = connectors[w];
+			Result result;
+			std::this_thread::sleep_until(origin);
+			for(const RecordedQuery* recorded : plans[w])
+			{
+				clock_type::time_point due = origin;
+				if(options.speedup > 0)
+				{
+					due += std::chrono::duration_cast<clock_type::duration>(std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(recorded->start) / options.speedup)));
+					std::this_thread::sleep_until(due);
+				}
+				clock_type::time_point begin = clock_type::now();
+				if(options.speedup > 0)
+				{
+					lag.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - due).count()));
+				}
+				bool ok = con.store(recorded->sql.c_str(), result);
+				latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - begin).count()));
+				errors += !ok;
+			}
+		});
+	}
+	for(std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	double seconds = std::chrono::duration<double>(clock_type::now() - origin).count();
+
+	HistogramSnapshot replayed = latency.snapshot();
+	std::string json = "{\n  \"tool\": \"query_replay\",\n";
+	json += "  \"log\": \"" + options.log + "\",\n";
+	json += "  \"queries\": " + std::to_string(replayed.count) + ",\n";
+	json += "  \"recorded_connections\": " + std::to_string(sessions.size()) + ",\n";
+	json += "  \"concurrency\": " + std::to_string(concurrency) + ",\n";
+	json += "  \"speedup\": " + std::to_string(options.speedup) + ",\n";
+	json += "  \"seconds\": " + std::to_string(seconds) + ",\n";
+	json += "  \"queries_per_sec\": " + std::to_string(seconds > 0 ? static_cast<double>(replayed.count) / seconds : 0.0) + ",\n";
+	json += "  \"errors\": " + std::to_string(errors.load()) + ",\n";
+	json += "  \"recorded_errors\": " + std::to_string(recordedErrors) + ",\n";
+	json += "  \"latency\": " + latencyJson(replayed) + ",\n";
+	json += "  \"recorded_latency\": " + latencyJson(recordedLatency.snapshot()) + ",\n";
+	json += "  \"schedule_lag\": " + latencyJson(lag.snapshot()) + "\n}\n";
+	if(options.out.empty())
+	{
+		std::fputs(json.c_str(), stdout);
+	}
+	else
+	{
+		std::ofstream(options.out) << json;
+	}
+	return errors > recordedErrors ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+/**
+ *
+ * @file bulk_inserter.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector bulk insert source file
+ */
+
+#include "bulk_inserter.h"
+
+#include <charconv> /**Library needed to use std::from_chars and std::to_chars*/
+#include <cmath> /**Library needed to use std::isfinite*/
+
+/**
+ * Room left under max_allowed_packet for the packet header and anything the server adds.
+ */
+static const size_t PACKET_SLACK = 1024;
+
+/**
+ * Prepares the INSERT prefix and works out how large a statement may grow.
+ * @param con Connected Connector to insert through. It must outlive the BulkInserter.
+ * @param table Table to insert into, quoted already if it needs to be.
+ * @param columns Columns every row provides values for, in order.
+ * @param maxStatement Largest statement to send in bytes. 0 asks the server for max_allowed_packet and stays just under it.
+ * @return If the inserter is ready to take rows or not.
+ */
+bool BulkInserter::open(Connector& con, const char* table, const vector<string>& columns, size_t maxStatement)
+{
+	_con = &con;
+	_error.clear();
+	_rowsBuffered = 0;
+	_rowsWritten = 0;
+	_num_values = 0;
+	_badValue = false;
+	_row.clear();
+	_num_columns = static_cast<unsigned int>(columns.size());
+	if(columns.empty())
+	{
+		_error = "At least one column is needed.";
+		return false;
+	}
+
+	if(maxStatement == 0)
+	{
+		Result result;
+		if(!con.store("SELECT @@max_allowed_packet", result) || result.empty())
+		{
+			_error = con.getError();
+			return false;
+		}
+		string_view value = result[0][0];
+		std::from_chars(value.data(), value.data() + value.size(), maxStatement);
+		maxStatement = maxStatement > 2 * PACKET_SLACK ? maxStatement - PACKET_SLACK : PACKET_SLACK;
+	}
+	_maxStatement = maxStatement;
+
+	_statement = "INSERT INTO ";
+	_statement += table;
+	_statement += " (";
+	for(size_t i = 0; i < columns.size(); i++)
+	{
+		if(i)
+		{
+			_statement += ',';
+		}
+		_statement += columns[i];
+	}
+	_statement += ") VALUES ";
+	_prefixLength = _statement.size();
+	return true;
+}
+
+/**
+ * Opens a value in the current row, adding the separator it needs.
+ */
+void BulkInserter::beginValue()
+{
+	_row += _num_values == 0 ? '(' : ',';
+	_num_values++;
+}
+
+/**
+ * Adds a signed integer to the current row.
+ * @param value Value of the next column.
+ * @return The current object, so values can be chained.
+ */
+BulkInserter& BulkInserter::addInt64(int64_t value)
+{
+	char text[24];
+	beginValue();
+	_row.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+	return *this;
+}
+
+/**
+ * Adds an unsigned integer to the current row.
+ * @param value Value of the next column.
+ * @return The current object, so values can be chained.
+ */
+BulkInserter& BulkInserter::addUInt64(uint64_t value)
+{
+	char text[24];
+	beginValue();
+	_row.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+	return *this;
+}
+
+/**
+ * Adds a floating point number to the current row. NaN and infinity have no SQL literal and are written as NULL.
+ * @param value Value of the next column.
+ * @return The current object, so values can be chained.
+ */
+BulkInserter& BulkInserter::addDouble(double value)
+{
+	if(!std::isfinite(value))
+	{
+		return addNull();
+	}
+	char text[32];
+	beginValue();
+	_row.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+	return *this;
+}
+
+/**
+ * Adds a string to the current row, escaped for the connection character set.
+ * @param value Value of the next column.
+ * @return The current object, so values can be chained.
+ */
+BulkInserter& BulkInserter::addString(string_view value)
+{
+	beginValue();
+	_row += '\'';
+	size_t start = _row.size();
+	_row.resize(start + value.size() * 2 + 1);
+	unsigned long written = mysql_real_escape_string(_con->getMYSQL_Ptr(), &_row[start], value.data(), static_cast<unsigned long>(value.size()));
+	if(written == static_cast<unsigned long>(-1))
+	{
+		// Happens when the session runs with NO_BACKSLASH_ESCAPES; the row is rejected in endRow().
+		_badValue = true;
+		written = 0;
+	}
+	_row.resize(start + written);
+	_row += '\'';
+	return *this;
+}
+
+/**
+ * Adds SQL NULL to the current row.
+ * @return The current object, so values can be chained.
+ */
+BulkInserter& BulkInserter::addNull()
+{
+	beginValue();
+	_row += "NULL";
+	return *this;
+}
+
+/**
+ * Finishes the current row and appends it to the pending statement. When the row does not fit under the size limit
+ * anymore, the pending statement is sent first.
+ * @return If the row was accepted (and any flush it triggered succeeded) or not. A rejected row is discarded.
+ */
+bool BulkInserter::endRow()
+{
+	bool badValue = _badValue;
+	unsigned int num_values = _num_values;
+	_badValue = false;
+	_num_values = 0;
+	if(badValue)
+	{
+		_row.clear();
+		_error = "Could not escape a value of the row.";
+		return false;
+	}
+	if(num_values != _num_columns)
+	{
+		_row.clear();
+		_error = "Row has " + std::to_string(num_values) + " values but " + std::to_string(_num_columns) + " columns were given.";
+		return false;
+	}
+	_row += ')';
+
+	if(_prefixLength + _row.size() > _maxStatement)
+	{
+		_row.clear();
+		_error = "Row is larger than the maximum statement size.";
+		return false;
+	}
+	if(_statement.size() + 1 + _row.size() > _maxStatement && !flush())
+	{
+		_row.clear();
+		return false;
+	}
+
+	if(_rowsBuffered)
+	{
+		_statement += ',';
+	}
+	_statement += _row;
+	_row.clear();
+	_rowsBuffered++;
+	return true;
+}
+
+/**
+ * Sends the pending statement, if any.
+ * @return If the pending rows were inserted or not. On failure they are discarded.
+ */
+bool BulkInserter::flush()
+{
+	if(_rowsBuffered == 0)
+	{
+		return true;
+	}
+	bool rval = _con->query(_statement.data(), static_cast<unsigned long>(_statement.size()));
+	if(rval)
+	{
+		_rowsWritten += _con->getNumAffectedRows();
+	}
+	else
+	{
+		_error = _con->getError();
+	}
+	_statement.resize(_prefixLength);
+	_rowsBuffered = 0;
+	return rval;
+}
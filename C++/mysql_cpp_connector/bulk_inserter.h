@@ -0,0 +1,66 @@
+/**
+ *
+ * @file bulk_inserter.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Batches rows into multi-row INSERT statements sized to the server packet limit
+ */
+
+#ifndef BULK_INSERTER_H
+#define BULK_INSERTER_H
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::int64_t and std::uint64_t*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "connector.h" /**Header needed to use Connector*/
+
+/**
+ * Accumulates rows and writes them as INSERT INTO table (columns) VALUES (...),(...),... statements.
+ * Values are escaped with mysql_real_escape_string straight into a buffer that is reused from statement to statement,
+ * and a statement is sent as soon as the next row would push it past the packet limit. Thousands of rows then cost
+ * a single round trip and a single parse on the server.
+ *
+ * Add the values of a row in column order, call endRow(), repeat, and call flush() at the end.
+ */
+class BulkInserter
+{
+	Connector* _con = nullptr; /**<Connector the statements are sent through.*/
+	string _statement; /**<Statement being built, starting with the INSERT prefix.*/
+	size_t _prefixLength = 0; /**<Length of "INSERT INTO table (columns) VALUES " at the start of _statement.*/
+	string _row; /**<Values of the row being built.*/
+	size_t _maxStatement = 0; /**<Largest statement that will be sent, in bytes.*/
+	unsigned int _num_columns = 0; /**<Number of values every row must have.*/
+	unsigned int _num_values = 0; /**<Number of values added to the current row so far.*/
+	size_t _rowsBuffered = 0; /**<Rows in _statement not sent yet.*/
+	my_ulonglong _rowsWritten = 0; /**<Rows inserted so far.*/
+	bool _badValue = false; /**<Boolean that stores if a value of the current row could not be escaped*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	void beginValue();
+
+	public:
+	BulkInserter() = default;
+	bool open(Connector& con, const char* table, const vector<string>& columns, size_t maxStatement = 0);
+	BulkInserter& addInt64(int64_t value);
+	BulkInserter& addUInt64(uint64_t value);
+	BulkInserter& addDouble(double value);
+	BulkInserter& addString(string_view value);
+	BulkInserter& addNull();
+	bool endRow();
+	bool flush();
+	inline size_t getNumRowsBuffered() const {return _rowsBuffered;}
+	inline my_ulonglong getNumRowsWritten() const {return _rowsWritten;}
+	inline size_t getMaxStatementSize() const {return _maxStatement;}
+	inline string getError() const {return _error;}
+};
+
+#endif // BULK_INSERTER_H
@@ -0,0 +1,340 @@
+/**
+ *
+ * @file column_decoder.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector column decoder source file
+ */
+
+#include "column_decoder.h"
+
+#include <charconv> /**Library needed to use std::from_chars*/
+#include <cstring> /**Library needed to use std::memcpy*/
+
+#if defined(__SSE4_1__)
+#include <immintrin.h> /**Header needed to use the SSE4.1 intrinsics*/
+#endif
+
+namespace
+{
+	/**
+	 * Powers of ten that a double holds exactly.
+	 */
+	const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+	                        1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	/**
+	 * Largest integer every smaller integer of which a double holds exactly.
+	 */
+	const uint64_t MAX_EXACT_DOUBLE = uint64_t(1) << 53;
+
+	/**
+	 * Most digits converted by the SIMD path. 16 digits never overflow 64 bits.
+	 */
+	const size_t MAX_SIMD_DIGITS = 16;
+
+	/**
+	 * Digits of an integer cell with the sign split off.
+	 */
+	struct Digits
+	{
+		const char* first; /**<First digit.*/
+		size_t length; /**<Number of digits.*/
+		bool negative; /**<If a minus sign preceded the digits.*/
+	};
+
+	/**
+	 * Splits the sign off an integer cell.
+	 */
+	inline Digits splitSign(const char* cell, size_t length)
+	{
+		bool negative = length && cell[0] == '-';
+		return Digits{cell + negative, length - negative, negative};
+	}
+
+	/**
+	 * Converts a whole cell with std::from_chars.
+	 * @return If the cell was a valid number of type T from its first to its last byte.
+	 */
+	template <typename T>
+	inline bool parseFallback(const char* cell, size_t length, T& out)
+	{
+		std::from_chars_result parsed = std::from_chars(cell, cell + length, out);
+		return parsed.ec == std::errc() && parsed.ptr == cell + length;
+	}
+
+#if defined(__SSE4_1__)
+#if defined(__SANITIZE_ADDRESS__)
+#define COLUMN_DECODER_COPY_LOADS 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define COLUMN_DECODER_COPY_LOADS 1
+#endif
+#endif
+
+	/**
+	 * 16 zero bytes then 16 set bytes. Loading 16 bytes at offset n gives a mask keeping the last n lanes.
+	 */
+	alignas(16) const signed char LENGTH_MASK[32] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	                                                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+	/**
+	 * Shuffle controls closing the gap a decimal point leaves: for a point in lane p, lanes 0 to p-1 move up one
+	 * lane and lane 0 becomes zero.
+	 */
+	struct PointShuffles
+	{
+		alignas(16) signed char control[16][16]; /**<Control for a point in each lane.*/
+
+		constexpr PointShuffles() : control()
+		{
+			for(int p = 0; p < 16; p++)
+			{
+				for(int i = 0; i < 16; i++)
+				{
+					control[p][i] = static_cast<signed char>(i == 0 ? -128 : (i <= p ? i - 1 : i));
+				}
+			}
+		}
+	};
+	constexpr PointShuffles POINT_SHUFFLES;
+
+	/**
+	 * Mask keeping the last length lanes of a window.
+	 */
+	inline __m128i keepLast(size_t length)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(LENGTH_MASK + length));
+	}
+
+	/**
+	 * Loads the 16 bytes ending at end, of which only the last length belong to the cell. When the window stays
+	 * inside one page it is loaded straight from the client library buffer; the bytes before the cell are masked off
+	 * by the caller. Near a page start (and under AddressSanitizer) the cell is copied into a buffer first.
+	 */
+	inline __m128i loadWindow(const char* end, size_t length)
+	{
+#if !defined(COLUMN_DECODER_COPY_LOADS)
+		if((reinterpret_cast<uintptr_t>(end - 1) & 4095) >= 15)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(end - 16));
+		}
+#endif
+		alignas(16) char buffer[16] = {};
+		std::memcpy(buffer + sizeof(buffer) - length, end - length, length);
+		return _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+	}
+
+	/**
+	 * Turns a window into digit values, zeroing every lane before the last length.
+	 */
+	inline __m128i toDigits(__m128i window, size_t length)
+	{
+		return _mm_and_si128(_mm_sub_epi8(window, _mm_set1_epi8('0')), keepLast(length));
+	}
+
+	/**
+	 * Checks that every lane holds a value from 0 to 9.
+	 */
+	inline bool allDigits(__m128i digits)
+	{
+		__m128i nine = _mm_set1_epi8(9);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine)) == 0xFFFF;
+	}
+
+	/**
+	 * Collapses 16 digit values (most significant first) into one number. Each step multiplies neighbours by their
+	 * place value and adds them: pairs, then groups of 4, then the two groups of 8.
+	 */
+	inline uint64_t combineDigits(__m128i digits)
+	{
+		__m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+		__m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+		__m128i packed = _mm_packus_epi32(quads, quads);
+		__m128i groups = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+		return uint64_t(static_cast<uint32_t>(_mm_cvtsi128_si32(groups))) * 100000000 + static_cast<uint32_t>(_mm_extract_epi32(groups, 1));
+	}
+
+	/**
+	 * Converts 1 to 16 ASCII digits.
+	 * @return If every byte was a digit.
+	 */
+	inline bool parseDigits(const char* first, size_t length, uint64_t& out)
+	{
+		__m128i digits = toDigits(loadWindow(first + length, length), length);
+		if(!allDigits(digits))
+		{
+			return false;
+		}
+		out = combineDigits(digits);
+		return true;
+	}
+
+	/**
+	 * Converts a plain decimal of 1 to 16 characters, digits with at most one point that is not the first character.
+	 * @param mantissa Receives the digits as one integer.
+	 * @param fractionLength Receives the number of digits after the point.
+	 * @return If the text had that shape.
+	 */
+	inline bool parseDecimal(const char* first, size_t length, uint64_t& mantissa, size_t& fractionLength)
+	{
+		__m128i window = loadWindow(first + length, length);
+		unsigned points = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(window, _mm_set1_epi8('.')), keepLast(length))));
+		__m128i digits = toDigits(window, length);
+		fractionLength = 0;
+		if(points)
+		{
+			unsigned lane = static_cast<unsigned>(__builtin_ctz(points));
+			if((points & (points - 1)) || lane == 16 - length)
+			{
+				return false;
+			}
+			fractionLength = 15 - lane;
+			digits = _mm_shuffle_epi8(digits, _mm_load_si128(reinterpret_cast<const __m128i*>(POINT_SHUFFLES.control[lane])));
+		}
+		if(!allDigits(digits))
+		{
+			return false;
+		}
+		mantissa = combineDigits(digits);
+		return true;
+	}
+#endif
+
+	/**
+	 * Checks if digits fit the SIMD path.
+	 */
+	inline bool fitsSimd(const Digits& digits)
+	{
+		return digits.length && digits.length <= MAX_SIMD_DIGITS;
+	}
+
+	/**
+	 * Converts one signed integer cell.
+	 */
+	inline bool parseInt64(const char* cell, size_t length, int64_t& out)
+	{
+#if defined(__SSE4_1__)
+		Digits digits = splitSign(cell, length);
+		uint64_t value;
+		if(fitsSimd(digits) && parseDigits(digits.first, digits.length, value))
+		{
+			out = digits.negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+			return true;
+		}
+#endif
+		return parseFallback(cell, length, out);
+	}
+
+	/**
+	 * Converts one unsigned integer cell.
+	 */
+	inline bool parseUInt64(const char* cell, size_t length, uint64_t& out)
+	{
+#if defined(__SSE4_1__)
+		if(length && length <= MAX_SIMD_DIGITS && parseDigits(cell, length, out))
+		{
+			return true;
+		}
+#endif
+		return parseFallback(cell, length, out);
+	}
+
+	/**
+	 * Converts one floating point cell. Plain decimals of up to 16 characters whose digits form an integer a
+	 * double holds exactly are computed as that integer divided by a power of ten. Both operands are exact, so the one
+	 * rounding of the division gives the same correctly rounded double as std::from_chars. Anything else, exponents
+	 * included, goes through std::from_chars.
+	 */
+	inline bool parseDouble(const char* cell, size_t length, double& out)
+	{
+#if defined(__SSE4_1__)
+		Digits digits = splitSign(cell, length);
+		uint64_t mantissa;
+		size_t fractionLength;
+		if(fitsSimd(digits) && parseDecimal(digits.first, digits.length, mantissa, fractionLength) && mantissa <= MAX_EXACT_DOUBLE)
+		{
+			double value = static_cast<double>(mantissa) / POW10[fractionLength];
+			out = digits.negative ? -value : value;
+			return true;
+		}
+#endif
+		return parseFallback(cell, length, out);
+	}
+}
+
+/**
+ * Converts a column of signed integer cells (TINYINT through BIGINT, YEAR).
+ * @param cells Text of every cell, nullptr for NULL.
+ * @param lengths Length of every cell.
+ * @param count Number of cells.
+ * @param out Receives one value per cell, 0 for NULL.
+ * @return Number of cells converted before the first invalid one, count when all were valid.
+ */
+size_t decodeInt64Column(const char* const* cells, const unsigned long* lengths, size_t count, int64_t* out)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = 0;
+		if(cells[i] && !parseInt64(cells[i], lengths[i], out[i]))
+		{
+			return i;
+		}
+	}
+	return count;
+}
+
+/**
+ * Converts a column of unsigned integer cells.
+ * @param cells Text of every cell, nullptr for NULL.
+ * @param lengths Length of every cell.
+ * @param count Number of cells.
+ * @param out Receives one value per cell, 0 for NULL.
+ * @return Number of cells converted before the first invalid one, count when all were valid.
+ */
+size_t decodeUInt64Column(const char* const* cells, const unsigned long* lengths, size_t count, uint64_t* out)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = 0;
+		if(cells[i] && !parseUInt64(cells[i], lengths[i], out[i]))
+		{
+			return i;
+		}
+	}
+	return count;
+}
+
+/**
+ * Converts a column of floating point cells (FLOAT, DOUBLE).
+ * @param cells Text of every cell, nullptr for NULL.
+ * @param lengths Length of every cell.
+ * @param count Number of cells.
+ * @param out Receives one value per cell, 0.0 for NULL.
+ * @return Number of cells converted before the first invalid one, count when all were valid.
+ */
+size_t decodeDoubleColumn(const char* const* cells, const unsigned long* lengths, size_t count, double* out)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = 0.0;
+		if(cells[i] && !parseDouble(cells[i], lengths[i], out[i]))
+		{
+			return i;
+		}
+	}
+	return count;
+}
+
+/**
+ * Tells which code path this build converts digits with.
+ * @return "sse4.1" or "scalar".
+ */
+const char* columnDecoderInstructionSet()
+{
+#if defined(__SSE4_1__)
+	return "sse4.1";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,32 @@
+/**
+ *
+ * @file column_decoder.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Whole-column parsing of text protocol numbers with SIMD digit conversion
+ */
+
+#ifndef COLUMN_DECODER_H
+#define COLUMN_DECODER_H
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::int64_t and std::uint64_t*/
+
+/**
+ * The text protocol sends every number as ASCII digits. These functions convert a whole column of such cells in one
+ * call instead of one std::from_chars per cell. Cells of up to 16 characters (every INT, most BIGINTs and plain
+ * decimals like prices) are turned into a number with a handful of SSE4.1 multiply-adds. Longer cells, exponents
+ * and anything unusual go through std::from_chars, which is also all that is used when the build does not enable
+ * SSE4.1 (-msse4.1, -mavx2 or -march=native). Results are identical either way.
+ *
+ * cells[i] points at the text of cell i and lengths[i] is its length. A nullptr cell is SQL NULL, its output is 0.
+ * Every function returns the number of cells converted before the first one that is not a valid number of the
+ * requested type, so a return value equal to count means the whole column was decoded.
+ */
+
+size_t decodeInt64Column(const char* const* cells, const unsigned long* lengths, size_t count, int64_t* out);
+size_t decodeUInt64Column(const char* const* cells, const unsigned long* lengths, size_t count, uint64_t* out);
+size_t decodeDoubleColumn(const char* const* cells, const unsigned long* lengths, size_t count, double* out);
+const char* columnDecoderInstructionSet();
+
+#endif // COLUMN_DECODER_H
@@ -0,0 +1,176 @@
+/**
+ *
+ * @file columnar_result.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector columnar result source file
+ */
+
+#include "columnar_result.h"
+
+#include "column_decoder.h" /**Header needed to use decodeInt64Column, decodeUInt64Column and decodeDoubleColumn*/
+
+/**
+ * Picks the storage used for a column from the type information the server sent.
+ * @param field Field description of the column.
+ * @return How the cells of the column will be stored.
+ */
+ColumnarResult::ColumnType ColumnarResult::columnType(const MYSQL_FIELD& field)
+{
+	switch(field.type)
+	{
+		case MYSQL_TYPE_TINY:
+		case MYSQL_TYPE_SHORT:
+		case MYSQL_TYPE_INT24:
+		case MYSQL_TYPE_LONG:
+		case MYSQL_TYPE_LONGLONG:
+			return (field.flags & UNSIGNED_FLAG) ? UNSIGNED_INTEGER : INTEGER;
+		case MYSQL_TYPE_YEAR:
+			return INTEGER;
+		case MYSQL_TYPE_FLOAT:
+		case MYSQL_TYPE_DOUBLE:
+			return DOUBLE;
+		default:
+			return STRING;
+	}
+}
+
+/**
+ * Decodes a buffered result set into typed columns. Any previously loaded data is replaced, reusing its storage.
+ * @param res Result set returned by mysql_store_result. It is read from the first row and left positioned at the end.
+ * @return If every cell was decoded or not.
+ */
+bool ColumnarResult::load(MYSQL_RES* res)
+{
+	clear();
+	_error.clear();
+	if(!res)
+	{
+		_error = "No result set to load.";
+		return false;
+	}
+
+	unsigned int num_fields = mysql_num_fields(res);
+	MYSQL_FIELD* fields = mysql_fetch_fields(res);
+	_num_rows = static_cast<size_t>(mysql_num_rows(res));
+	_num_columns = num_fields;
+	if(_columns.size() < num_fields)
+	{
+		_columns.resize(num_fields);
+	}
+	for(unsigned int i = 0; i < num_fields; i++)
+	{
+		Column& column = _columns[i];
+		column.name = fields[i].name;
+		column.type = columnType(fields[i]);
+		column.nulls.assign((_num_rows + 63) / 64, 0);
+		if(column.type == DOUBLE)
+		{
+			column.doubles.resize(_num_rows);
+		}
+		else if(column.type == STRING)
+		{
+			column.offsets.resize(_num_rows + 1);
+			column.offsets[0] = 0;
+		}
+		else
+		{
+			column.integers.resize(_num_rows);
+		}
+	}
+
+	// First pass, row by row: mark NULLs, append string cells and gather where every numeric cell is. The cell text
+	// stays in the buffer of the result set, so only a pointer and a length are copied.
+	size_t stride = _num_rows;
+	_cells.resize(stride * num_fields);
+	_lengths.resize(stride * num_fields);
+	mysql_data_seek(res, 0);
+	MYSQL_ROW row;
+	size_t r = 0;
+	while(r < _num_rows && (row = mysql_fetch_row(res)))
+	{
+		unsigned long* lengths = mysql_fetch_lengths(res);
+		for(unsigned int i = 0; i < num_fields; i++)
+		{
+			Column& column = _columns[i];
+			if(!row[i])
+			{
+				column.nulls[r / 64] |= uint64_t(1) << (r % 64);
+			}
+			if(column.type == STRING)
+			{
+				if(row[i])
+				{
+					column.bytes.insert(column.bytes.end(), row[i], row[i] + lengths[i]);
+				}
+				column.offsets[r + 1] = column.bytes.size();
+			}
+			else
+			{
+				_cells[i * stride + r] = row[i];
+				_lengths[i * stride + r] = lengths[i];
+			}
+		}
+		r++;
+	}
+	_num_rows = r;
+
+	// Second pass, column by column: each numeric column is converted in one call to the column decoder.
+	for(unsigned int i = 0; i < num_fields; i++)
+	{
+		Column& column = _columns[i];
+		const char* const* cells = _cells.data() + i * stride;
+		const unsigned long* lengths = _lengths.data() + i * stride;
+		size_t decoded = _num_rows;
+		switch(column.type)
+		{
+			case INTEGER:
+				decoded = decodeInt64Column(cells, lengths, _num_rows, column.integers.data());
+				break;
+			case UNSIGNED_INTEGER:
+				decoded = decodeUInt64Column(cells, lengths, _num_rows, reinterpret_cast<uint64_t*>(column.integers.data()));
+				break;
+			case DOUBLE:
+				decoded = decodeDoubleColumn(cells, lengths, _num_rows, column.doubles.data());
+				break;
+			case STRING:
+				break;
+		}
+		if(decoded != _num_rows)
+		{
+			_error = "Could not decode row " + std::to_string(decoded) + " of column " + column.name + ".";
+			clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Empties the result while keeping the storage of each column for reuse.
+ */
+void ColumnarResult::clear()
+{
+	for(Column& column : _columns)
+	{
+		column.integers.clear();
+		column.doubles.clear();
+		column.bytes.clear();
+		column.offsets.clear();
+		column.nulls.clear();
+	}
+	_num_columns = 0;
+	_num_rows = 0;
+}
+
+/**
+ * Reads a cell of a STRING column.
+ * @param row Row index.
+ * @param column Column index.
+ * @return View of the cell bytes, valid until the result is loaded again or cleared. NULL cells are empty.
+ */
+string_view ColumnarResult::getString(size_t row, size_t column) const
+{
+	const Column& c = _columns[column];
+	return string_view(c.bytes.data() + c.offsets[row], c.offsets[row + 1] - c.offsets[row]);
+}
@@ -0,0 +1,88 @@
+/**
+ *
+ * @file columnar_result.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Typed, column-oriented storage for a MySQL result set
+ */
+
+#ifndef COLUMNAR_RESULT_H
+#define COLUMNAR_RESULT_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::int64_t and std::uint64_t*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+/**
+ * Holds a result set one column at a time instead of one row at a time.
+ * Every column is decoded exactly once, using the MYSQL_FIELD type sent by the server, into a contiguous native array:
+ * integers into int64_t, FLOAT/DOUBLE into double and everything else into one packed byte buffer with an offset per row.
+ * NULL cells are tracked in a bitmap per column. Reading a cell is an array index, no std::any and no heap allocation.
+ */
+class ColumnarResult
+{
+	public:
+	/**
+	 * How the cells of a column are stored.
+	 */
+	enum ColumnType
+	{
+		INTEGER, /**<Signed integer types (TINYINT through BIGINT, YEAR), stored as int64_t.*/
+		UNSIGNED_INTEGER, /**<Unsigned integer types, stored as the bit pattern of a uint64_t in the int64_t array.*/
+		DOUBLE, /**<FLOAT and DOUBLE, stored as double.*/
+		STRING /**<Everything else (DECIMAL, temporal, text and binary types), stored as raw bytes.*/
+	};
+
+	private:
+	/**
+	 * Storage for a single column. Only the array matching type is populated.
+	 */
+	struct Column
+	{
+		string name; /**<Field name as sent by the server.*/
+		ColumnType type = STRING; /**<How the cells of this column are stored.*/
+		vector<int64_t> integers; /**<One value per row for INTEGER and UNSIGNED_INTEGER columns.*/
+		vector<double> doubles; /**<One value per row for DOUBLE columns.*/
+		vector<char> bytes; /**<Packed cell bytes for STRING columns.*/
+		vector<size_t> offsets; /**<Row r of a STRING column spans bytes[offsets[r], offsets[r + 1]).*/
+		vector<uint64_t> nulls; /**<Bitmap with bit r set when row r is NULL.*/
+	};
+
+	vector<Column> _columns; /**<Decoded columns in field order. Kept allocated across loads so their storage is reused.*/
+	size_t _num_columns = 0; /**<Number of columns decoded.*/
+	size_t _num_rows = 0; /**<Number of rows decoded.*/
+	vector<const char*> _cells; /**<Scratch: text of the numeric cells, gathered column by column.*/
+	vector<unsigned long> _lengths; /**<Scratch: lengths of the cells in _cells.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	static ColumnType columnType(const MYSQL_FIELD& field);
+
+	public:
+	bool load(MYSQL_RES* res);
+	void clear();
+	inline string getError() const {return _error;}
+	inline size_t getNumRows() const {return _num_rows;}
+	inline size_t getNumColumns() const {return _num_columns;}
+	inline const string& getName(size_t column) const {return _columns[column].name;}
+	inline ColumnType getType(size_t column) const {return _columns[column].type;}
+	inline bool isNull(size_t row, size_t column) const {return (_columns[column].nulls[row / 64] >> (row % 64)) & 1;}
+	inline int64_t getInt64(size_t row, size_t column) const {return _columns[column].integers[row];}
+	inline uint64_t getUInt64(size_t row, size_t column) const {return static_cast<uint64_t>(_columns[column].integers[row]);}
+	inline double getDouble(size_t row, size_t column) const {return _columns[column].doubles[row];}
+	string_view getString(size_t row, size_t column) const;
+	inline const int64_t* getInt64Column(size_t column) const {return _columns[column].integers.data();}
+	inline const double* getDoubleColumn(size_t column) const {return _columns[column].doubles.data();}
+	inline const uint64_t* getNullBitmap(size_t column) const {return _columns[column].nulls.data();}
+};
+
+#endif // COLUMNAR_RESULT_H
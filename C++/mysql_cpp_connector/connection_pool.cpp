@@ -0,0 +1,299 @@
+/**
+ *
+ * @file connection_pool.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector connection pool source file
+ */
+
+#include "connection_pool.h"
+
+#include <utility> /**Library needed to use std::exchange*/
+
+/**
+ * Move Constructor
+ * @param handle Handle whose borrowed connection is taken over.
+ */
+ConnectionPool::Handle::Handle(Handle&& handle) noexcept :
+	_pool{std::exchange(handle._pool, nullptr)},
+	_index{handle._index}
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs Handle whose borrowed connection is taken over.
+ * @return The current object after the move has been complete.
+ */
+ConnectionPool::Handle& ConnectionPool::Handle::operator=(Handle&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		release();
+		_pool = std::exchange(rhs._pool, nullptr);
+		_index = rhs._index;
+	}
+	return *this;
+}
+
+/**
+ * Returns the borrowed connection to its pool early. The Handle is empty afterwards.
+ */
+void ConnectionPool::Handle::release()
+{
+	if(_pool)
+	{
+		_pool->giveBack(_index);
+		_pool = nullptr;
+	}
+}
+
+/**
+ * Basic Destructor
+ */
+ConnectionPool::Handle::~Handle()
+{
+	release();
+}
+
+/**
+ * Opens every connection of the pool, in parallel, and starts the keepalive thread.
+ * @param options Parameters every connection is opened with.
+ * @param size Number of connections the pool holds.
+ * @param keepalive How long a connection may sit idle before it is pinged. Zero disables the keepalive thread.
+ * @return If every connection was opened or not. On failure no connection is left open.
+ */
+bool ConnectionPool::open(const ConnectionOptions& options, size_t size, clock::duration keepalive)
+{
+	close();
+	_error.clear();
+	_options = options;
+	_keepaliveInterval = keepalive;
+
+	// Constructing a Connector only allocates its MYSQL structure; the handshakes are what take time and run in parallel.
+	_connectors.resize(size);
+
+	vector<std::thread> workers;
+	workers.reserve(size);
+	for(size_t i = 0; i < size; i++)
+	{
+		workers.emplace_back([this, i]()
+		{
+			ThreadScope scope;
+			_connectors[i].connect(_options);
+		});
+	}
+	for(std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	for(const Connector& connector : _connectors)
+	{
+		if(!connector.isConnected())
+		{
+			_error = connector.getError();
+			_connectors.clear();
+			return false;
+		}
+	}
+
+	_lastUsed.assign(size, clock::now());
+	_broken.assign(size, false);
+	_free.clear();
+	_free.reserve(size);
+	for(size_t i = size; i > 0; i--)
+	{
+		_free.push_back(i - 1);
+	}
+	_stopping = false;
+	if(_keepaliveInterval > clock::duration::zero())
+	{
+		_keepalive = std::thread(&ConnectionPool::keepaliveLoop, this);
+	}
+	return true;
+}
+
+/**
+ * Takes the connection on top of the free stack. A connection the keepalive thread could not reopen is tried once
+ * more first; if that fails too it goes back on the stack and the Handle is empty, with getError() set.
+ * @param lock Lock on _mutex, held with _free not empty. It is released while reconnecting and held again on return.
+ * @return Handle on a connected Connector, or an empty Handle.
+ */
+ConnectionPool::Handle ConnectionPool::borrow(std::unique_lock<std::mutex>& lock)
+{
+	size_t index = _free.back();
+	_free.pop_back();
+	if(!_broken[index])
+	{
+		return Handle(this, index);
+	}
+	lock.unlock();
+	bool reopened = _connectors[index].reconnect(_options);
+	lock.lock();
+	if(reopened)
+	{
+		_broken[index] = false;
+		return Handle(this, index);
+	}
+	_error = "Could not reopen a dropped connection: " + _connectors[index].getError();
+	_free.insert(_free.begin(), index);
+	return Handle();
+}
+
+/**
+ * Borrows a connection, waiting for as long as it takes for one to be returned.
+ * @return Handle on a connected Connector, or an empty Handle if the pool is closed or a dropped connection could not
+ *         be reopened (see getError()).
+ */
+ConnectionPool::Handle ConnectionPool::acquire()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_available.wait(lock, [this]() {return !_free.empty() || _stopping || _connectors.empty();});
+	if(_free.empty())
+	{
+		return Handle();
+	}
+	return borrow(lock);
+}
+
+/**
+ * Borrows a connection, waiting at most timeout for one to be returned.
+ * @param timeout Longest time to wait.
+ * @return Handle on a connected Connector, or an empty Handle if none became available in time or a dropped
+ *         connection could not be reopened (see getError()).
+ */
+ConnectionPool::Handle ConnectionPool::acquire(clock::duration timeout)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if(!_available.wait_for(lock, timeout, [this]() {return !_free.empty() || _stopping || _connectors.empty();}) || _free.empty())
+	{
+		return Handle();
+	}
+	return borrow(lock);
+}
+
+/**
+ * Borrows a connection only if one is available right now.
+ * @return Handle on a connected Connector, or an empty Handle.
+ */
+ConnectionPool::Handle ConnectionPool::tryAcquire()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if(_free.empty())
+	{
+		return Handle();
+	}
+	return borrow(lock);
+}
+
+/**
+ * Puts a connection back on the free stack and wakes one waiting borrower.
+ * @param index Slot of the connection being returned.
+ */
+void ConnectionPool::giveBack(size_t index)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_lastUsed[index] = clock::now();
+		_free.push_back(index);
+	}
+	_available.notify_one();
+}
+
+/**
+ * Background loop that pings connections idle for longer than the keepalive interval.
+ * Connections being pinged are taken off the free stack so nobody borrows them meanwhile.
+ * A connection that fails its ping is reopened with Connector::reconnect, keeping what was set on it. One that cannot
+ * be reopened is marked broken, so the next borrower tries again instead of getting a dead connection.
+ */
+void ConnectionPool::keepaliveLoop()
+{
+	ThreadScope scope;
+	vector<size_t> idle;
+	vector<bool> broken;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(!_stopping)
+	{
+		_wake.wait_for(lock, _keepaliveInterval / 2, [this]() {return _stopping;});
+		if(_stopping)
+		{
+			break;
+		}
+
+		clock::time_point now = clock::now();
+		idle.clear();
+		for(size_t i = 0; i < _free.size();)
+		{
+			if(now - _lastUsed[_free[i]] >= _keepaliveInterval)
+			{
+				idle.push_back(_free[i]);
+				_free[i] = _free.back();
+				_free.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+		if(idle.empty())
+		{
+			continue;
+		}
+
+		lock.unlock();
+		broken.clear();
+		for(size_t index : idle)
+		{
+			broken.push_back(mysql_ping(_connectors[index].getMYSQL_Ptr()) != 0 && !_connectors[index].reconnect(_options));
+		}
+		lock.lock();
+		now = clock::now();
+		for(size_t i = 0; i < idle.size(); i++)
+		{
+			_lastUsed[idle[i]] = now;
+			_broken[idle[i]] = broken[i];
+			_free.push_back(idle[i]);
+		}
+		_available.notify_all();
+	}
+}
+
+/**
+ * Counts the connections that are not borrowed right now.
+ * @return Number of connections available to borrow.
+ */
+size_t ConnectionPool::getNumAvailable()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _free.size();
+}
+
+/**
+ * Stops the keepalive thread and closes every connection. All Handles must have been released beforehand.
+ */
+void ConnectionPool::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+	_available.notify_all();
+	if(_keepalive.joinable())
+	{
+		_keepalive.join();
+	}
+	_free.clear();
+	_lastUsed.clear();
+	_broken.clear();
+	_connectors.clear();
+}
+
+/**
+ * Basic Destructor
+ */
+ConnectionPool::~ConnectionPool()
+{
+	close();
+}
@@ -0,0 +1,93 @@
+/**
+ *
+ * @file connection_pool.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Bounded, thread-safe pool of pre-connected Connectors
+ */
+
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <chrono> /**Library needed to use std::chrono*/
+#include <condition_variable> /**Library needed to use std::condition_variable*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <mutex> /**Library needed to use std::mutex*/
+#include <thread> /**Library needed to use std::thread*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include "connector.h" /**Header needed to use Connector*/
+
+/**
+ * Keeps a fixed number of Connectors connected so threads can borrow one instead of doing a TCP and
+ * authentication handshake of their own. All connections are opened in parallel by open(). Borrowing and
+ * returning only push or pop an index under a mutex held for a handful of instructions. A background thread
+ * pings connections that have sat idle for a keepalive interval and reconnects any that were dropped.
+ */
+class ConnectionPool
+{
+	public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * A borrowed connection. It goes back to the pool when the Handle is destroyed or release() is called.
+	 */
+	class Handle
+	{
+		ConnectionPool* _pool = nullptr; /**<Pool the connection belongs to, nullptr when empty.*/
+		size_t _index = 0; /**<Slot of the connection inside the pool.*/
+
+		public:
+		Handle() = default;
+		Handle(ConnectionPool* pool, size_t index) : _pool(pool), _index(index) {}
+		Handle(const Handle& handle) = delete;
+		Handle& operator=(const Handle& rhs) = delete;
+		Handle(Handle&& handle) noexcept;
+		Handle& operator=(Handle&& rhs) noexcept;
+		void release();
+		inline explicit operator bool() const {return _pool != nullptr;}
+		inline Connector& operator*() const {return _pool->_connectors[_index];}
+		inline Connector* operator->() const {return &_pool->_connectors[_index];}
+		~Handle();
+	};
+
+	private:
+	ConnectionOptions _options; /**<Parameters every connection in the pool is opened with.*/
+	vector<Connector> _connectors; /**<Every connection the pool owns.*/
+	vector<clock::time_point> _lastUsed; /**<When each connection was last returned or pinged.*/
+	vector<size_t> _free; /**<Stack of connection slots that are available to borrow.*/
+	vector<bool> _broken; /**<Connections that were dropped and could not be opened again yet.*/
+	std::mutex _mutex; /**<Guards _free, _lastUsed, _broken and _stopping.*/
+	std::condition_variable _available; /**<Signalled when a connection is returned.*/
+	std::condition_variable _wake; /**<Signalled to stop the keepalive thread early.*/
+	std::thread _keepalive; /**<Background thread pinging idle connections.*/
+	clock::duration _keepaliveInterval{}; /**<How long a connection may sit idle before it is pinged.*/
+	bool _stopping = false; /**<Boolean that stores if the pool is shutting down*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	Handle borrow(std::unique_lock<std::mutex>& lock);
+	void giveBack(size_t index);
+	void keepaliveLoop();
+
+	public:
+	ConnectionPool() = default;
+	ConnectionPool(const ConnectionPool& pool) = delete;
+	ConnectionPool& operator=(const ConnectionPool& rhs) = delete;
+	bool open(const ConnectionOptions& options, size_t size, clock::duration keepalive = std::chrono::seconds(30));
+	Handle acquire();
+	Handle acquire(clock::duration timeout);
+	Handle tryAcquire();
+	void close();
+	size_t getNumAvailable();
+	inline size_t getSize() const {return _connectors.size();}
+	inline const ConnectionOptions& getOptions() const {return _options;}
+	inline string getError() const {return _error;}
+	~ConnectionPool();
+};
+
+#endif // CONNECTION_POOL_H
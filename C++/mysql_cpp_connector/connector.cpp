@@ -8,94 +8,184 @@
 
 #include "connector.h"
 
+#include <cstdlib> /**Library needed to use std::strtoull*/
+#include <cstring> /**Library needed to use std::strlen, std::strcmp and std::strncpy*/
+#include <utility> /**Library needed to use std::exchange and std::move*/
+
+namespace
+{
+    const uint64_t MAX_PACKET_PAYLOAD = 0xFFFFFF; /**<Largest payload of one protocol packet, longer ones are split.*/
+    const uint64_t OK_PACKET_BYTES = 7; /**<Payload of an OK or EOF packet without a status message.*/
+    const uint64_t COLUMN_FIXED_BYTES = 13; /**<Fixed length fields of a column definition.*/
+
+    /**
+     * Size of the length encoded integer the protocol puts in front of a value.
+     */
+    inline uint64_t lenencSize(uint64_t value)
+    {
+        return value < 251 ? 1 : value < 0x10000 ? 3 : value < 0x1000000 ? 4 : 9;
+    }
+
+    /**
+     * Bytes a payload takes on an uncompressed connection: the payload and a 4 byte header per packet it is split into.
+     */
+    inline uint64_t packetBytes(uint64_t payload)
+    {
+        return payload + 4 * (payload / MAX_PACKET_PAYLOAD + 1);
+    }
+
+    /**
+     * State shared with the LOCAL INFILE callbacks for one load.
+     */
+    struct LocalInfile
+    {
+        const Connector::DataProducer* producer; /**<Callback supplying the data.*/
+        bool failed; /**<Boolean that stores if the producer aborted the load*/
+    };
+
+    /**
+     * LOCAL INFILE init callback. The file name in the statement is ignored, data always comes from the producer.
+     */
+    int localInfileInit(void** ptr, const char*, void* userdata)
+    {
+        *ptr = userdata;
+        return 0;
+    }
+
+    /**
+     * LOCAL INFILE read callback. Hands the client library buffer straight to the producer.
+     */
+    int localInfileRead(void* ptr, char* buf, unsigned int buf_len)
+    {
+        LocalInfile* infile = static_cast<LocalInfile*>(ptr);
+        long n = (*infile->producer)(buf,buf_len);
+        if(n < 0)
+        {
+            infile->failed = true;
+            return -1;
+        }
+        return static_cast<int>(n < static_cast<long>(buf_len) ? n : static_cast<long>(buf_len));
+    }
+
+    /**
+     * LOCAL INFILE end callback. Nothing to release, the state lives on the stack of loadLocalData.
+     */
+    void localInfileEnd(void*)
+    {
+    }
+
+    /**
+     * LOCAL INFILE error callback. Reports why the load was aborted.
+     */
+    int localInfileError(void*, char* error_msg, unsigned int error_msg_len)
+    {
+        std::strncpy(error_msg,"Data producer aborted the load.",error_msg_len);
+        if(error_msg_len)
+        {
+            error_msg[error_msg_len - 1] = '\0';
+        }
+        return 2000;
+    }
+}
+
 /**
  * Basic Constructor
  * @param con passes in another main MYSQL C Structure pointer that can be used for initialization.
  */
 Connector::Connector(MYSQL* con) :
     _row{MYSQL_ROW()},
+    _arena{},
+    _cells{},
     _data{},
     _fieldNames{},
     _error{}
 {
-    if(mysql_library_init(0,nullptr,nullptr))
+    if(!_runtime.isInitialized())
 	{
 		_error = "Could not initialize MySQL client library.";
-		_lib_failed = true;
 	}
 	else
 	{
-	    _lib_initialized = true;
-		_con = mysql_init(con);
+		_con.reset(mysql_init(con));
 		if(!_con)
 		{
-			_error = mysql_error(_con);
+			_error = "Could not allocate the MYSQL C structure.";
 		}
 	}
 }
 
 /**
- * Copy Constructor
- * @param con Connector to be copied.
+ * Move Constructor
+ * @param con Connector whose connection and results are taken over. It is left without a connection.
  */
-Connector::Connector(const Connector& con) :
-    _row{MYSQL_ROW()},
-    _data{},
-    _fieldNames{},
-    _error{}
+Connector::Connector(Connector&& con) noexcept :
+    _runtime{std::move(con._runtime)},
+    _con{std::move(con._con)},
+    _res{std::move(con._res)},
+    _statements{std::move(con._statements)},
+    _field{std::exchange(con._field,nullptr)},
+    _row{std::exchange(con._row,nullptr)},
+    _num_fields{std::exchange(con._num_fields,0)},
+    _arena{std::move(con._arena)},
+    _cells{std::move(con._cells)},
+    _num_rows{std::exchange(con._num_rows,0)},
+    _data{std::move(con._data)},
+    _dataBuilt{std::exchange(con._dataBuilt,false)},
+    _fieldNames{std::move(con._fieldNames)},
+    _affectedRows{std::exchange(con._affectedRows,0)},
+    _connected{std::exchange(con._connected,false)},
+    _definitionStatement{std::exchange(con._definitionStatement,false)},
+    _multiStatements{std::exchange(con._multiStatements,false)},
+    _clientFlags{std::exchange(con._clientFlags,0)},
+    _batch{std::move(con._batch)},
+    _metrics{std::exchange(con._metrics,nullptr)},
+    _queryCache{std::exchange(con._queryCache,nullptr)},
+    _recorder{std::exchange(con._recorder,nullptr)},
+    _countWireBytes{std::exchange(con._countWireBytes,false)},
+    _wire{std::move(con._wire)},
+    _wireBase{std::move(con._wireBase)},
+    _uncommittedTables{std::move(con._uncommittedTables)},
+    _error{std::move(con._error)}
 {
-    _num_fields = 0;
-    _affectedRows = 0;
-    _connected = false;
-    _lib_failed = false;
-    _lib_initialized = con.isLibraryInitialized();
-    _definitionStatement = false;
-    _field = nullptr;
-    _res = nullptr;
-    _con = nullptr;
-    if(!_lib_initialized)
-    {
-        if(mysql_library_init(0,nullptr,nullptr))
-        {
-            _error = "Could not initialize MySQL client library.";
-            _lib_failed = true;
-        }
-        else
-        {
-            _lib_initialized = true;
-        }
-    }
-
-    mysql_init(con.getMYSQL_Ptr());
-    if(!con.getMYSQL_Ptr())
-    {
-        _error = mysql_error(con.getMYSQL_Ptr());
-    }
 }
 
 /**
- * Overloaded assignment operator
- * @param rhs Connector that will be copied based on which it is assigned.
- * @return The current object after assignment has been complete.
+ * Move assignment operator
+ * @param rhs Connector whose connection and results are taken over. It is left without a connection.
+ * @return The current object after the move has been complete.
  */
-Connector& Connector::operator=(const Connector& rhs)
+Connector& Connector::operator=(Connector&& rhs) noexcept
 {
-    _error = rhs.getError();
-    _lib_initialized = rhs.isLibraryInitialized();
-    _lib_failed = rhs.MYSQL_lib_failed();
-    _definitionStatement = rhs.isDefinitionStatement();
-    _connected = rhs.isConnected();
-    _affectedRows = rhs.getNumAffectedRows();
-    _fieldNames = rhs.getFieldNames();
-    _num_fields = rhs.getNumFields();
-    _row = rhs.getMYSQL_ROW_Struct();
-    _field = rhs.getMYSQL_FIELD_Ptr();
-    _res = rhs.getMYSQL_RES_Ptr();
-    _con = rhs.getMYSQL_Ptr();
-
-    for(size_t i = 0; i < rhs.getData().size(); i++)
+    if(this != &rhs)
     {
-        _data[i] = rhs.getData()[i];
+        release();
+        _runtime = std::move(rhs._runtime);
+        _con = std::move(rhs._con);
+        _res = std::move(rhs._res);
+        _statements = std::move(rhs._statements);
+        _field = std::exchange(rhs._field,nullptr);
+        _row = std::exchange(rhs._row,nullptr);
+        _num_fields = std::exchange(rhs._num_fields,0);
+        _arena = std::move(rhs._arena);
+        _cells = std::move(rhs._cells);
+        _num_rows = std::exchange(rhs._num_rows,0);
+        _data = std::move(rhs._data);
+        _dataBuilt = std::exchange(rhs._dataBuilt,false);
+        _fieldNames = std::move(rhs._fieldNames);
+        _affectedRows = std::exchange(rhs._affectedRows,0);
+        _connected = std::exchange(rhs._connected,false);
+        _definitionStatement = std::exchange(rhs._definitionStatement,false);
+        _multiStatements = std::exchange(rhs._multiStatements,false);
+        _clientFlags = std::exchange(rhs._clientFlags,0);
+        _batch = std::move(rhs._batch);
+        _metrics = std::exchange(rhs._metrics,nullptr);
+        _queryCache = std::exchange(rhs._queryCache,nullptr);
+        _recorder = std::exchange(rhs._recorder,nullptr);
+        _countWireBytes = std::exchange(rhs._countWireBytes,false);
+        _wire = std::move(rhs._wire);
+        _wireBase = std::move(rhs._wireBase);
+        _uncommittedTables = std::move(rhs._uncommittedTables);
+        _error = std::move(rhs._error);
     }
     return *this;
 }
@@ -113,18 +203,199 @@ Connector& Connector::operator=(const Connector& rhs)
  */
 bool Connector::connect(const char* host, const char* user, const char* pass, const char* db, const unsigned& port, const char* unix_port, const unsigned long& client_flags)
 {
-	if(mysql_real_connect(_con,host,user,pass,db,port,unix_port,client_flags) == nullptr)
+	if(mysql_real_connect(_con.get(),host,user,pass,db,port,unix_port,client_flags) == nullptr)
 	{
-		_error = mysql_error(_con);
+		_error = mysql_error(_con.get());
 		_connected = false;
 	}
 	else
 	{
 		_connected = true;
+		_multiStatements = (client_flags & CLIENT_MULTI_STATEMENTS) != 0;
+		_clientFlags = client_flags;
+		_wire = WireStats();
+		_wireBase = WireStats();
 	}
 	return _connected;
 }
 
+/**
+ * Used to connect to a target database
+ * @param options stores every connection parameter.
+ * @see Connector::connect(const char* host, const char* user, const char* pass, const char* db, const unsigned& port, const char* unix_port, const unsigned long& client_flags)
+ * @return If Connector has successfully connected or not.
+ */
+bool Connector::connect(const ConnectionOptions& options)
+{
+    if(options.compression != Compression::NONE && !setCompression(options.compression,options.compression_level))
+    {
+        return false;
+    }
+    _countWireBytes = options.count_wire_bytes;
+    return connect(options.host.empty() ? nullptr : options.host.c_str(),
+                   options.user.c_str(),
+                   options.pass.c_str(),
+                   options.db.empty() ? nullptr : options.db.c_str(),
+                   options.port,
+                   options.unix_socket.empty() ? nullptr : options.unix_socket.c_str(),
+                   options.client_flags);
+}
+
+/**
+ * Replaces the connection with a new one opened with options, for example after it was dropped. What was set on the
+ * Connector carries over: metrics, query cache, recorder, wire accounting and the statement cache capacity.
+ * Compression is asked for again from options.
+ * @param options Parameters of the new connection.
+ * @return If the new connection was opened or not. On failure the old connection is kept and getError() is set.
+ */
+bool Connector::reconnect(const ConnectionOptions& options)
+{
+    Connector fresh;
+    if(!fresh.connect(options))
+    {
+        _error = fresh.getError();
+        return false;
+    }
+    fresh._metrics = _metrics;
+    fresh._queryCache = _queryCache;
+    fresh._recorder = _recorder;
+    fresh._countWireBytes = _countWireBytes;
+    fresh._statements.setCapacity(_statements.getCapacity());
+    *this = std::move(fresh);
+    return true;
+}
+
+/**
+ * Picks the protocol compression of the next connect(). Compression::ZLIB works with any client library and server;
+ * Compression::ZSTD needs a MySQL 8.0.18 or later client library, and the connection then fails unless the server
+ * supports zstd as well. Which compression a session ended up with can be checked with getWireStats().
+ * @param compression Compression to ask the server for.
+ * @param level zstd level from 1 (fastest) to 22 (smallest), ignored for zlib.
+ * @return If the client library supports the compression or not.
+ */
+bool Connector::setCompression(Compression compression, unsigned level)
+{
+#if defined(MARIADB_PACKAGE_VERSION_ID) || !defined(MYSQL_VERSION_ID) || MYSQL_VERSION_ID < 80018
+    // Older MySQL and every MariaDB client library only know CLIENT_COMPRESS, which is zlib.
+    (void)level;
+    if(compression == Compression::ZSTD)
+    {
+        _error = "zstd protocol compression needs a MySQL 8.0.18 or later client library.";
+        return false;
+    }
+    if(compression == Compression::ZLIB && mysql_options(_con.get(),MYSQL_OPT_COMPRESS,nullptr))
+    {
+        _error = mysql_error(_con.get());
+        return false;
+    }
+    return true;
+#else
+    const char* algorithms = compression == Compression::ZSTD ? "zstd" : compression == Compression::ZLIB ? "zlib" : "uncompressed";
+    if(mysql_options(_con.get(),MYSQL_OPT_COMPRESSION_ALGORITHMS,algorithms) ||
+       (compression == Compression::ZSTD && mysql_options(_con.get(),MYSQL_OPT_ZSTD_COMPRESSION_LEVEL,&level)))
+    {
+        _error = mysql_error(_con.get());
+        return false;
+    }
+    return true;
+#endif
+}
+
+/**
+ * Reads the session byte counters of the server, and whether the session is compressed, into stats.
+ * @param stats Receives wireBytesSent, wireBytesReceived, compressed and algorithm.
+ * @return If the counters could be read or not.
+ */
+bool Connector::readServerBytes(WireStats& stats)
+{
+    // Sent and received are seen from the server, the other way around from the connection.
+    static const char STATUS[] = "SHOW SESSION STATUS WHERE Variable_name IN ('Bytes_sent','Bytes_received','Compression','Compression_algorithm')";
+    if(mysql_real_query(_con.get(),STATUS,sizeof(STATUS) - 1))
+    {
+        _error = mysql_error(_con.get());
+        return false;
+    }
+    MYSQL_RES* res = mysql_store_result(_con.get());
+    if(!res)
+    {
+        _error = mysql_error(_con.get());
+        return false;
+    }
+    MYSQL_ROW row;
+    while((row = mysql_fetch_row(res)))
+    {
+        if(!row[0] || !row[1])
+        {
+            continue;
+        }
+        if(std::strcmp(row[0],"Bytes_sent") == 0)
+        {
+            stats.wireBytesReceived = std::strtoull(row[1],nullptr,10);
+        }
+        else if(std::strcmp(row[0],"Bytes_received") == 0)
+        {
+            stats.wireBytesSent = std::strtoull(row[1],nullptr,10);
+        }
+        else if(std::strcmp(row[0],"Compression") == 0)
+        {
+            stats.compressed = std::strcmp(row[1],"ON") == 0;
+        }
+        else
+        {
+            stats.algorithm = row[1];
+        }
+    }
+    mysql_free_result(res);
+    if(!stats.algorithm.empty())
+    {
+        // MySQL 8.0.18 and later report the algorithm, with "uncompressed" for plain sessions.
+        stats.compressed = stats.algorithm != "uncompressed";
+    }
+    else if(stats.compressed)
+    {
+        stats.algorithm = "zlib";
+    }
+    return true;
+}
+
+/**
+ * Reports how many bytes the connection moved since it was opened or since resetWireStats(), before and after
+ * compression. The raw counts are only gathered while wire accounting is on (setWireAccounting() or
+ * ConnectionOptions::count_wire_bytes). Each call runs a SHOW STATUS, whose few hundred bytes land in the wire counts.
+ * @param stats Receives the counts.
+ * @return If the server counters could be read or not.
+ */
+bool Connector::getWireStats(WireStats& stats)
+{
+    WireStats server;
+    if(!readServerBytes(server))
+    {
+        return false;
+    }
+    stats = _wire;
+    stats.wireBytesSent = server.wireBytesSent - _wireBase.wireBytesSent;
+    stats.wireBytesReceived = server.wireBytesReceived - _wireBase.wireBytesReceived;
+    stats.compressed = server.compressed;
+    stats.algorithm = server.algorithm;
+    return true;
+}
+
+/**
+ * Starts the byte counts of getWireStats() over from zero, leaving out the handshake and everything run so far.
+ * @return If the server counters could be read or not.
+ */
+bool Connector::resetWireStats()
+{
+    WireStats server;
+    if(!readServerBytes(server))
+    {
+        return false;
+    }
+    _wireBase = server;
+    _wire = WireStats();
+    return true;
+}
+
 /**
  * Used to execute a query on a target database
  * @param query stores query in a const char* to be executed on target database.
@@ -132,74 +403,707 @@ bool Connector::connect(const char* host, const char* user, const char* pass, co
  */
 bool Connector::query(const char* query)
 {
-    _error.clear();
-    _data.clear();
-    _fieldNames.clear();
-    _affectedRows = 0;
-    _num_fields = 0;
+    return this->query(query,static_cast<unsigned long>(std::strlen(query)));
+}
+
+/**
+ * Used to execute a query of known length on a target database
+ * @param query stores query to be executed on target database. It does not need to be null terminated.
+ * @param length stores the length of query in bytes.
+ * @return If query was successfully executed or not.
+ */
+bool Connector::query(const char* query, unsigned long length)
+{
+    clearResults();
+    _res.reset();
+    QueryTimer timer = startTimer(query,length);
     bool rval = true;
-	if(mysql_query(_con,query))
+	if(mysql_real_query(_con.get(),query,length))
 	{
 	    rval = false;
-		_error = mysql_error(_con);
+		_error = mysql_error(_con.get());
 	}
 	else
 	{
-		_res = mysql_store_result(_con);
+		timer.lap(QueryMetrics::ROUND_TRIP);
+		_res.reset(mysql_store_result(_con.get()));
+		timer.lap(QueryMetrics::TRANSFER);
+		if(_countWireBytes)
+		{
+			countResultBytes(_res.get());
+			timer.skip();
+		}
 		if(!_res)
 		{
-			if(mysql_field_count(_con) != 0)
+			if(mysql_field_count(_con.get()) != 0)
 			{
 			    rval = false;
-				_error = mysql_error(_con);
+				_error = mysql_error(_con.get());
 			}
 			else
 			{
 			    _definitionStatement = true;
-				_affectedRows = mysql_affected_rows(_con);
+				_affectedRows = mysql_affected_rows(_con.get());
 			}
 		}
 		else
 		{
 		    _definitionStatement = false;
-			_num_fields = mysql_num_fields(_res);
-			while((_field = mysql_fetch_field(_res)))
+			_num_fields = mysql_num_fields(_res.get());
+			while((_field = mysql_fetch_field(_res.get())))
 			{
 				_fieldNames.push_back(_field->name);
 			}
 
-			while((_row = mysql_fetch_row(_res)))
+			// Cells are packed into the arena instead of a vector per row. The arena and index keep their
+			// capacity from query to query, so once they have grown large enough no further allocations happen.
+			_num_rows = static_cast<size_t>(mysql_num_rows(_res.get()));
+			_cells.reserve(_num_rows * _num_fields);
+			while((_row = mysql_fetch_row(_res.get())))
 			{
-				//vector<boost::any> d;
-				vector<any> d;
+				unsigned long* lengths = mysql_fetch_lengths(_res.get());
 				for(int i = 0; i < _num_fields; i++)
 				{
-					d.push_back(_row[i]);
+					if(!_row[i])
+					{
+						_cells.push_back(Cell{NULL_CELL,0});
+						continue;
+					}
+					_cells.push_back(Cell{_arena.size(),lengths[i]});
+					_arena.insert(_arena.end(),_row[i],_row[i] + lengths[i]);
+					_arena.push_back('\0');
 				}
-				_data.push_back(d);
-				d.clear();
 			}
+			// Everything has been copied out, so the client library's copy of the rows is freed right away.
+			_res.reset();
+			timer.lap(QueryMetrics::MATERIALIZE);
+		}
+		if(rval && !discardPendingResults())
+		{
+			rval = false;
+		}
+	}
+	size_t bytes = 0;
+	if(_metrics)
+	{
+		// Every non-null cell is followed by a null character in the arena, which is not counted as a cell byte.
+		bytes = _arena.size();
+		for(const Cell& cell : _cells)
+		{
+			bytes -= cell.offset != NULL_CELL;
 		}
 	}
+	timer.finish(rval,_num_rows,bytes);
+	notifyCache(query,length);
 	return rval;
 }
 
+/**
+ * Used to execute a query on a target database, handing the buffered result set over to a Result.
+ * Rows are read through Row views pointing into the client library buffer instead of being copied into getData().
+ * Errors are reported both through getError() and the error of result.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param result Result that takes ownership of the result set.
+ * @return If query was successfully executed or not.
+ */
+bool Connector::store(const char* query, Result& result)
+{
+    clearResults();
+    result.clear();
+    result.setError(string());
+    QueryTimer timer = startTimer(query,std::strlen(query));
+    if(mysql_query(_con.get(),query))
+    {
+        _error = mysql_error(_con.get());
+        result.setError(_error);
+        timer.finish(false);
+        return false;
+    }
+    timer.lap(QueryMetrics::ROUND_TRIP);
+    notifyCache(query,std::strlen(query));
+
+    MYSQL_RES* res = mysql_store_result(_con.get());
+    timer.lap(QueryMetrics::TRANSFER);
+    if(_countWireBytes)
+    {
+        countResultBytes(res);
+        timer.skip();
+    }
+    if(!result.load(_con.get(),res))
+    {
+        _error = result.getError();
+        timer.finish(false);
+        return false;
+    }
+    if(res)
+    {
+        timer.lap(QueryMetrics::MATERIALIZE);
+    }
+    if(!discardPendingResults())
+    {
+        timer.finish(false,result.getNumRows());
+        return false;
+    }
+    size_t bytes = 0;
+    if(_metrics)
+    {
+        for(const Row& row : result)
+        {
+            for(size_t i = 0; i < row.size(); i++)
+            {
+                bytes += row[i].size();
+            }
+        }
+    }
+    timer.finish(true,result.getNumRows(),bytes);
+
+    _definitionStatement = result.isDefinitionStatement();
+    _affectedRows = result.getNumAffectedRows();
+    _num_fields = result.getNumFields();
+    for(int i = 0; i < _num_fields; i++)
+    {
+        _fieldNames.emplace_back(result.getFieldName(i));
+    }
+    return true;
+}
+
+/**
+ * Used to execute a query on a target database without buffering its result set.
+ * Rows are read off the socket one at a time through the given Cursor instead of being copied into getData().
+ * No other query can be run on this Connector until the Cursor has been exhausted or closed.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param cursor Cursor that will stream the rows of the result set.
+ * @return If query was successfully executed or not.
+ */
+bool Connector::stream(const char* query, Cursor& cursor)
+{
+    clearResults();
+    cursor.close();
+    QueryTimer timer = startTimer(query,std::strlen(query));
+    if(mysql_query(_con.get(),query))
+    {
+        _error = mysql_error(_con.get());
+        timer.finish(false);
+        return false;
+    }
+    timer.lap(QueryMetrics::ROUND_TRIP);
+    notifyCache(query,std::strlen(query));
+
+    // Rows are read by the caller after stream() returns, so only the round trip is timed.
+    if(!cursor.open(_con.get()))
+    {
+        if(!cursor.getError().empty())
+        {
+            _error = cursor.getError();
+            timer.finish(false);
+            return false;
+        }
+        _definitionStatement = true;
+        _affectedRows = mysql_affected_rows(_con.get());
+        bool rval = discardPendingResults();
+        timer.finish(rval);
+        return rval;
+    }
+    timer.finish(true);
+
+    _definitionStatement = false;
+    _num_fields = cursor.getNumFields();
+    _fieldNames = cursor.getFieldNames();
+    return true;
+}
+
+/**
+ * Used to execute a query on a target database and decode its result set into typed columns.
+ * The rows are decoded straight from the client library buffer into result, getData() is left empty.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param result ColumnarResult that receives the decoded columns. Its storage is reused between calls.
+ * @return If query was successfully executed and decoded or not.
+ */
+bool Connector::queryColumnar(const char* query, ColumnarResult& result)
+{
+    clearResults();
+    result.clear();
+    QueryTimer timer = startTimer(query,std::strlen(query));
+    if(mysql_query(_con.get(),query))
+    {
+        _error = mysql_error(_con.get());
+        timer.finish(false);
+        return false;
+    }
+    timer.lap(QueryMetrics::ROUND_TRIP);
+    notifyCache(query,std::strlen(query));
+
+    MYSQL_RES* res = mysql_store_result(_con.get());
+    timer.lap(QueryMetrics::TRANSFER);
+    if(_countWireBytes)
+    {
+        countResultBytes(res);
+        timer.skip();
+    }
+    if(!res)
+    {
+        if(mysql_field_count(_con.get()) != 0)
+        {
+            _error = mysql_error(_con.get());
+            timer.finish(false);
+            return false;
+        }
+        _definitionStatement = true;
+        _affectedRows = mysql_affected_rows(_con.get());
+        bool rval = discardPendingResults();
+        timer.finish(rval);
+        return rval;
+    }
+
+    _definitionStatement = false;
+    bool rval = result.load(res);
+    mysql_free_result(res);
+    timer.lap(QueryMetrics::MATERIALIZE);
+    if(!rval)
+    {
+        _error = result.getError();
+        timer.finish(false);
+        return false;
+    }
+    if(!discardPendingResults())
+    {
+        timer.finish(false,result.getNumRows());
+        return false;
+    }
+    timer.finish(true,result.getNumRows());
+    _num_fields = static_cast<int>(result.getNumColumns());
+    for(size_t i = 0; i < result.getNumColumns(); i++)
+    {
+        _fieldNames.push_back(result.getName(i));
+    }
+    return true;
+}
+
+/**
+ * Used to execute a query on a target database whose result set may not fit in memory.
+ * Rows are streamed into result, which moves them to a memory-mapped temp file once they pass its spill threshold.
+ * getData() is left empty.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param result SpillableResult that will receive the rows of the result set.
+ * @return If query was successfully executed and every row was stored or not.
+ */
+bool Connector::querySpillable(const char* query, SpillableResult& result)
+{
+    Cursor cursor;
+    if(!stream(query,cursor))
+    {
+        result.clear();
+        return false;
+    }
+    if(!result.load(cursor))
+    {
+        _error = result.getError();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Used to prepare a statement on the target database for repeated execution over the binary protocol.
+ * @param query stores the statement in a const char*, with ? for every parameter.
+ * @param stmt Statement that receives the prepared handle.
+ * @return If the statement was successfully prepared or not.
+ */
+bool Connector::prepare(const char* query, Statement& stmt)
+{
+    _error.clear();
+    if(!stmt.prepare(_con.get(),query))
+    {
+        _error = stmt.getError();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Used to get a prepared statement from the Connector's statement cache, preparing it only the first time the SQL is
+ * seen (or again after the connection was re-established). Running the same parameterized query repeatedly then costs
+ * one execute round trip. The cache keeps 64 statements by default, see getStatementCache().setCapacity().
+ * @param query stores the SQL of the statement, with ? placeholders for its parameters.
+ * @return The statement, owned by the Connector and valid until it is evicted from the cache, or nullptr on error.
+ */
+Statement* Connector::prepareCached(const char* query)
+{
+    _error.clear();
+    Statement* stmt = _statements.get(_con.get(),query);
+    if(!stmt)
+    {
+        _error = _statements.getError();
+    }
+    return stmt;
+}
+
+/**
+ * Used to execute several statements in a single round trip, collecting one Result per statement.
+ * The statements are sent as one packet and every result is walked with mysql_more_results/mysql_next_result.
+ * If the Connector was not connected with CLIENT_MULTI_STATEMENTS, multi statement support is switched on for the batch and off again afterwards.
+ * @param statements stores the statements in a const char*, separated by semicolons.
+ * @param results receives one Result per statement that ran. When a statement fails its Result carries the error and the statements after it are not run.
+ * @return If every statement was successfully executed or not.
+ */
+bool Connector::batch(const char* statements, vector<Result>& results)
+{
+    clearResults();
+    results.clear();
+    // Stacked statements are only accepted for the batch itself, so an injected "; DROP ..." in a later query() still fails.
+    bool enabled = false;
+    if(!_multiStatements)
+    {
+        if(mysql_set_server_option(_con.get(),MYSQL_OPTION_MULTI_STATEMENTS_ON))
+        {
+            _error = mysql_error(_con.get());
+            return false;
+        }
+        enabled = true;
+    }
+
+    bool rval = true;
+    if(mysql_query(_con.get(),statements))
+    {
+        _error = mysql_error(_con.get());
+        results.emplace_back();
+        results.back().setError(_error);
+        rval = false;
+    }
+    else
+    {
+        for(;;)
+        {
+            results.emplace_back();
+            if(!results.back().load(_con.get()))
+            {
+                _error = results.back().getError();
+                discardPendingResults();
+                rval = false;
+                break;
+            }
+
+            int status = mysql_next_result(_con.get());
+            if(status < 0)
+            {
+                break;
+            }
+            if(status > 0)
+            {
+                _error = mysql_error(_con.get());
+                results.emplace_back();
+                results.back().setError(_error);
+                rval = false;
+                break;
+            }
+        }
+        notifyCache(statements,std::strlen(statements));
+    }
+
+    if(enabled && mysql_set_server_option(_con.get(),MYSQL_OPTION_MULTI_STATEMENTS_OFF) && rval)
+    {
+        _error = mysql_error(_con.get());
+        rval = false;
+    }
+    return rval;
+}
+
+/**
+ * Used to execute several statements in a single round trip, collecting one Result per statement.
+ * @param statements stores every statement to execute, without trailing semicolons.
+ * @param results receives one Result per statement that ran.
+ * @see Connector::batch(const char* statements, vector<Result>& results)
+ * @return If every statement was successfully executed or not.
+ */
+bool Connector::batch(const vector<string>& statements, vector<Result>& results)
+{
+    _batch.clear();
+    for(const string& statement : statements)
+    {
+        if(!_batch.empty())
+        {
+            _batch += ';';
+        }
+        _batch += statement;
+    }
+    return batch(_batch.c_str(),results);
+}
+
+/**
+ * Used to run a LOAD DATA LOCAL INFILE statement whose data comes from a callback instead of a file.
+ * The client library asks the producer for one buffer at a time and streams it to the server, so no temporary file
+ * is written and memory use stays at a single buffer however much data is loaded. The file name in the statement is ignored.
+ * The Connector must have been connected with CLIENT_LOCAL_FILES in its client flags.
+ * @param statement stores the LOAD DATA LOCAL INFILE statement in a const char*.
+ * @param producer fills each buffer with the next chunk of data, see DataProducer.
+ * @return If all data was loaded or not. getNumAffectedRows() holds the number of rows loaded.
+ */
+bool Connector::loadLocalData(const char* statement, const DataProducer& producer)
+{
+    if(!(_clientFlags & CLIENT_LOCAL_FILES))
+    {
+        _error = "Connector must be connected with CLIENT_LOCAL_FILES to load local data.";
+        return false;
+    }
+
+    // LOCAL INFILE is only switched on for this statement. Left on, any later LOAD DATA LOCAL the server asks for
+    // would read client files through the default handler.
+    unsigned int previous = 0;
+    if(mysql_get_option(_con.get(),MYSQL_OPT_LOCAL_INFILE,&previous))
+    {
+        previous = 0;
+    }
+    unsigned int enable = 1;
+    mysql_options(_con.get(),MYSQL_OPT_LOCAL_INFILE,&enable);
+    LocalInfile infile{&producer,false};
+    mysql_set_local_infile_handler(_con.get(),localInfileInit,localInfileRead,localInfileEnd,localInfileError,&infile);
+    bool rval = query(statement);
+    mysql_set_local_infile_default(_con.get());
+    mysql_options(_con.get(),MYSQL_OPT_LOCAL_INFILE,&previous);
+    if(infile.failed && rval)
+    {
+        _error = "Data producer aborted the load.";
+        rval = false;
+    }
+    return rval;
+}
+
+/**
+ * Used to execute a SELECT through the QueryCache set with setQueryCache(). A cached, unexpired result of the same
+ * statement is handed out without contacting the server; otherwise the statement runs like store() and its result is
+ * cached for the next caller. Statements that are not cacheable (see QueryCache::isCacheable) always run, and so does
+ * everything while the Connector's own transaction has uncommitted writes.
+ * On a hit nothing describing the last statement is kept by the Connector, read everything from result instead.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param result Receives the result, shared with the cache and every other caller of the same statement.
+ * @param ttl How long a new entry is served, zero for the TTL of the cache.
+ * @return If query was successfully executed (or found in the cache) or not.
+ */
+bool Connector::queryCached(const char* query, std::shared_ptr<const Result>& result, QueryCache::clock::duration ttl)
+{
+    result.reset();
+    string key;
+    bool cacheable = false;
+    uint64_t generation = 0;
+    if(_queryCache && _uncommittedTables.empty())
+    {
+        key = QueryCache::normalize(query);
+        cacheable = QueryCache::isCacheable(key);
+        if(cacheable)
+        {
+            // Unqualified table names resolve against the default database, so the same text may read other tables.
+            const char* db = _con->db;
+            key.push_back('\0');
+            key += db ? db : "";
+            result = _queryCache->get(key);
+            if(result)
+            {
+                clearResults();
+                return true;
+            }
+            generation = _queryCache->getGeneration();
+        }
+    }
+
+    std::shared_ptr<Result> fresh = std::make_shared<Result>();
+    bool rval = store(query,*fresh);
+    if(rval && cacheable)
+    {
+        _queryCache->put(key,fresh,generation,ttl);
+    }
+    result = std::move(fresh);
+    return rval;
+}
+
+/**
+ * Accessor that returns the retrieved data as a two dimensional std::vector of std::any, each holding a char* (nullptr for NULL).
+ * The vectors are only built on the first call after a query, and the char* point into the Connector's own storage, valid until the next query.
+ * getCell() and getCString() read the same data without building anything.
+ * @return The rows retrieved by the last call to query().
+ */
+const vector<vector<any> >& Connector::getData() const
+{
+    if(!_dataBuilt)
+    {
+        _data.resize(_num_rows);
+        for(size_t r = 0; r < _num_rows; r++)
+        {
+            //vector<boost::any>& d = _data[r];
+            vector<any>& d = _data[r];
+            d.clear();
+            for(int i = 0; i < _num_fields; i++)
+            {
+                d.push_back(const_cast<char*>(getCString(r,i)));
+            }
+        }
+        _dataBuilt = true;
+    }
+    return _data;
+}
+
+/**
+ * Resets everything describing the last statement before a new one runs. Storage is kept for reuse.
+ */
+void Connector::clearResults()
+{
+    _error.clear();
+    _arena.clear();
+    _cells.clear();
+    _num_rows = 0;
+    _dataBuilt = false;
+    _fieldNames.clear();
+    _affectedRows = 0;
+    _num_fields = 0;
+}
+
+/**
+ * Reads and throws away the results of any statements after the first when several statements were sent at once.
+ * Without this the connection is left out of sync and the next query fails.
+ * @return If every remaining statement succeeded or not.
+ */
+bool Connector::discardPendingResults()
+{
+    while(mysql_more_results(_con.get()))
+    {
+        if(mysql_next_result(_con.get()) > 0)
+        {
+            _error = mysql_error(_con.get());
+            return false;
+        }
+        MYSQL_RES* res = mysql_store_result(_con.get());
+        if(res)
+        {
+            mysql_free_result(res);
+        }
+    }
+    return true;
+}
+
+/**
+ * Starts timing a statement for the metrics and the capture log, and counts its raw bytes when wire accounting is on.
+ * The server connection id is only looked up when recording.
+ * @param query Statement about to run. It must stay alive until the timer finishes.
+ * @param length Length of the statement in bytes.
+ * @return The timer.
+ */
+QueryTimer Connector::startTimer(const char* query, size_t length)
+{
+    if(_countWireBytes)
+    {
+        // COM_QUERY: the command byte and the statement, plus a packet header per 16MB.
+        _wire.rawBytesSent += packetBytes(length + 1);
+    }
+    return QueryTimer(_metrics,_recorder,_recorder ? mysql_thread_id(_con.get()) : 0,string_view(query,length));
+}
+
+/**
+ * Adds the raw protocol size of a buffered result set to the wire stats: the column count, the column definitions,
+ * every text row and the packets ending the definitions and the rows. Statements without a result set count as an
+ * OK packet. The result is left on its first row.
+ * @param res Buffered result set, or nullptr.
+ */
+void Connector::countResultBytes(MYSQL_RES* res)
+{
+    if(!res)
+    {
+        _wire.rawBytesReceived += packetBytes(OK_PACKET_BYTES);
+        return;
+    }
+    countHeaderBytes(res);
+    unsigned int num_fields = mysql_num_fields(res);
+    MYSQL_ROW row;
+    while((row = mysql_fetch_row(res)))
+    {
+        countRowBytes(row,mysql_fetch_lengths(res),num_fields);
+    }
+    mysql_data_seek(res,0);
+}
+
+/**
+ * Adds the raw protocol size of everything in a result set but its rows to the wire stats: the column count, the
+ * column definitions and the packets ending the definitions and the rows.
+ * @param res Result set, buffered or not.
+ */
+void Connector::countHeaderBytes(MYSQL_RES* res)
+{
+    unsigned int num_fields = mysql_num_fields(res);
+    MYSQL_FIELD* fields = mysql_fetch_fields(res);
+    uint64_t bytes = packetBytes(lenencSize(num_fields)) + 2 * packetBytes(OK_PACKET_BYTES);
+    for(unsigned int i = 0; i < num_fields; i++)
+    {
+        const MYSQL_FIELD& f = fields[i];
+        uint64_t definition = COLUMN_FIXED_BYTES;
+        for(uint64_t length : {uint64_t(f.catalog_length), uint64_t(f.db_length), uint64_t(f.table_length),
+                               uint64_t(f.org_table_length), uint64_t(f.name_length), uint64_t(f.org_name_length)})
+        {
+            definition += lenencSize(length) + length;
+        }
+        bytes += packetBytes(definition);
+    }
+    _wire.rawBytesReceived += bytes;
+}
+
+/**
+ * Adds the raw protocol size of one text row to the wire stats.
+ * @param row Row as returned by mysql_fetch_row.
+ * @param lengths Cell lengths as returned by mysql_fetch_lengths.
+ * @param num_fields Number of cells in the row.
+ */
+void Connector::countRowBytes(MYSQL_ROW row, const unsigned long* lengths, unsigned int num_fields)
+{
+    uint64_t payload = 0;
+    for(unsigned int i = 0; i < num_fields; i++)
+    {
+        // SQL NULL is the single byte 0xFB.
+        payload += row[i] ? lenencSize(lengths[i]) + lengths[i] : 1;
+    }
+    _wire.rawBytesReceived += packetBytes(payload);
+}
+
+/**
+ * Tells the query cache a statement ran, so entries reading the tables it wrote are dropped. Other connections only
+ * see writes made inside a transaction once it commits, so those tables are invalidated once more when it ends.
+ * @param query Statement that ran.
+ * @param length Length of the statement in bytes.
+ */
+void Connector::notifyCache(const char* query, size_t length)
+{
+    if(!_queryCache)
+    {
+        return;
+    }
+    vector<string> tables = _queryCache->invalidate(string_view(query,length));
+    if(_con && (_con->server_status & SERVER_STATUS_IN_TRANS))
+    {
+        _uncommittedTables.insert(_uncommittedTables.end(),tables.begin(),tables.end());
+    }
+    else if(!_uncommittedTables.empty())
+    {
+        for(const string& table : _uncommittedTables)
+        {
+            _queryCache->invalidateTable(table);
+        }
+        _uncommittedTables.clear();
+    }
+}
+
+/**
+ * Closes the connection and drops the Connector's reference on the client library, in that order.
+ */
+void Connector::release()
+{
+    _res.reset();
+    _statements.clear();
+    _con.reset();
+    _connected = false;
+    _uncommittedTables.clear();
+    _runtime.release();
+}
+
 /**
  * Basic Destructor
  */
 Connector::~Connector()
 {
-	if(_res)
-	{
-		mysql_free_result(_res);
-		_res = nullptr;
-	}
-	if(_con)
-	{
-		mysql_close(_con);
-	}
-	if(!_lib_failed && _lib_initialized)
-	{
-		mysql_library_end();
-	}
+    release();
 }
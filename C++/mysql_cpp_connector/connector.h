@@ -27,48 +27,198 @@ using std::string;
 
 #include <any> /**Library needed to use std::any*/
 using std::any;
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <cstring> /**Library needed to use std::strlen*/
+#include <functional> /**Library needed to use std::function*/
+#include <memory> /**Library needed to use std::shared_ptr*/
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "cursor.h" /**Header needed to use Cursor*/
+#include "columnar_result.h" /**Header needed to use ColumnarResult*/
+#include "spillable_result.h" /**Header needed to use SpillableResult*/
+#include "result.h" /**Header needed to use Result*/
+#include "statement.h" /**Header needed to use Statement*/
+#include "statement_cache.h" /**Header needed to use StatementCache*/
+#include "handles.h" /**Header needed to use MysqlHandle and ResultHandle*/
+#include "runtime.h" /**Header needed to use ClientRuntime*/
+#include "metrics.h" /**Header needed to use QueryMetrics and QueryTimer*/
+#include "query_recorder.h" /**Header needed to use QueryRecorder*/
+#include "query_cache.h" /**Header needed to use QueryCache*/
+#include "typed_row.h" /**Header needed to use RowMapper*/
 /*
 #include <boost/any.hpp> <--- Library needed to use boost::any
 */
 
 
+/**
+ * Compression of the client/server protocol. It trades CPU on both ends for fewer bytes on the wire, which pays off for
+ * large result sets over a slow or metered network and costs latency on a fast one.
+ */
+enum class Compression
+{
+	NONE, /**<Uncompressed protocol.*/
+	ZLIB, /**<zlib (CLIENT_COMPRESS), understood by every MySQL and MariaDB server.*/
+	ZSTD /**<zstd, MySQL 8.0.18 or later on both the client library and the server.*/
+};
+
+/**
+ * Bytes a connection has moved since it was opened or since Connector::resetWireStats(), before and after compression.
+ * The raw side is worked out by the Connector from the protocol size of every text statement it sent and every result
+ * set read by query(), store(), queryColumnar() and queryAs(). The wire side comes from the session Bytes_received and Bytes_sent status of the server, so it
+ * also covers what the raw side does not see (prepared statements, batches, rows read through a Cursor) and the
+ * SHOW STATUS statements that read it.
+ */
+struct WireStats
+{
+	uint64_t rawBytesSent = 0; /**<Protocol bytes of the statements sent, before compression.*/
+	uint64_t rawBytesReceived = 0; /**<Protocol bytes of the result sets read, before compression.*/
+	uint64_t wireBytesSent = 0; /**<Bytes the server received from this connection.*/
+	uint64_t wireBytesReceived = 0; /**<Bytes the server sent to this connection.*/
+	bool compressed = false; /**<If the server reports the session as compressed.*/
+	string algorithm; /**<Compression algorithm the session uses, empty when the server does not report it.*/
+
+	/**
+	 * Raw bytes received per byte on the wire, 0 before anything was received.
+	 */
+	inline double receiveRatio() const {return wireBytesReceived ? static_cast<double>(rawBytesReceived) / static_cast<double>(wireBytesReceived) : 0.0;}
+};
+
+/**
+ * Everything needed to open a connection, held in owned strings so it can be kept around to open more connections later.
+ * Empty host, db and unix_socket are passed to the client library as nullptr (its defaults).
+ */
+struct ConnectionOptions
+{
+	string host; /**<Host name of the target mysql server.*/
+	string user; /**<MySQL user name.*/
+	string pass; /**<MySQL password.*/
+	string db; /**<Target mysql database/schema.*/
+	unsigned port = 0; /**<Port number mysql listens on, 0 for the default.*/
+	string unix_socket; /**<Unix socket or named pipe to connect through.*/
+	unsigned long client_flags = 0; /**<Flag information passed to main MYSQL C Structure to enable/disable features.*/
+	Compression compression = Compression::NONE; /**<Protocol compression to ask the server for.*/
+	unsigned compression_level = 3; /**<zstd level from 1 to 22, only used with Compression::ZSTD.*/
+	bool count_wire_bytes = false; /**<If the Connector works out the raw bytes of what it sends and reads (see WireStats).*/
+};
+
+/**
+ * Connection to a MySQL server. A Connector owns its MYSQL handle and the MYSQL_RES of its last query and releases
+ * both on its own. It can be moved, which makes it cheap to keep in containers and pools, but not copied since two
+ * objects sharing one connection would close it twice.
+ */
 class Connector
 {
-	MYSQL* _con = nullptr; /**<Main MySQL C structure.*/
-	MYSQL_RES* _res = nullptr; /**<MySQL Results C structure.*/
+	ClientRuntime _runtime; /**<Reference on the MySQL client library, initializing it if no Connector did before.*/
+	MysqlHandle _con; /**<Main MySQL C structure, closed when the Connector is destroyed.*/
+	ResultHandle _res; /**<MySQL Results C structure of query(), only held while its rows are packed into _arena, so getMYSQL_RES_Ptr() is nullptr afterwards.*/
+	StatementCache _statements; /**<Statements prepared through prepareCached(), closed before the connection.*/
 	MYSQL_FIELD* _field = nullptr; /**<MYSQL Field C structure.*/
 	MYSQL_ROW _row; /**<MYSQL Row C Structure*/
 	int _num_fields = 0; /**<Used to store number of fields retrieved*/
-	//vector<vector<boost::any> > _data; <-- Two dimensional std::vector used to store data retrieved using boost::any
-	vector<vector<any> > _data; /**<Two dimensional std::vector used to store data retrived.*/
+	/**
+	 * Location of one cell inside the arena.
+	 */
+	struct Cell
+	{
+		size_t offset; /**<Offset of the first byte in _arena, NULL_CELL for SQL NULL.*/
+		size_t length; /**<Length of the cell in bytes, not counting the terminating null character.*/
+	};
+	static constexpr size_t NULL_CELL = static_cast<size_t>(-1); /**<Cell offset marking SQL NULL.*/
+	vector<char> _arena; /**<Bytes of every cell retrieved, packed back to back, each followed by a null character.*/
+	vector<Cell> _cells; /**<Index into _arena, _num_fields cells per row.*/
+	size_t _num_rows = 0; /**<Used to store number of rows retrieved*/
+	//mutable vector<vector<boost::any> > _data; <-- Two dimensional std::vector used to store data retrieved using boost::any
+	mutable vector<vector<any> > _data; /**<Two dimensional std::vector of the retrieved data, only built when getData() is called.*/
+	mutable bool _dataBuilt = false; /**<Boolean that stores if _data matches the arena*/
 	vector<string> _fieldNames; /**<Vector of std::string used to store field names retrieved.*/
 	my_ulonglong _affectedRows = 0; /**<Used to store affected rows when no data can be retrieved*/
 	bool _connected = false; /**<Boolean that stores if Connector has established a connection with it's target database or not*/
-	bool _lib_failed = false; /**<Boolean that stores if the mysql_init_lib fails to initialize or not*/
-	bool _lib_initialized = false; /**<Boolean that stores if mysql_init_lib has already be initialized or not*/
 	bool _definitionStatement = false; /**<Boolean that stores if the processed query is either a Definition Statement or a Manipulation Statement*/
+	bool _multiStatements = false; /**<Boolean that stores if the server accepts several statements in one query*/
+	unsigned long _clientFlags = 0; /**<Client flags the connection was opened with.*/
+	string _batch; /**<Reusable buffer the statements of a batch are joined into.*/
+	QueryMetrics* _metrics = nullptr; /**<Metrics queries are recorded into, not owned. nullptr disables instrumentation.*/
+	QueryCache* _queryCache = nullptr; /**<Cache of SELECT results shared with other Connectors, not owned. nullptr disables caching.*/
+	QueryRecorder* _recorder = nullptr; /**<Capture log every query is appended to, not owned. nullptr disables recording.*/
+	bool _countWireBytes = false; /**<Boolean that stores if raw protocol bytes are counted into _wire*/
+	WireStats _wire; /**<Raw bytes counted since the last resetWireStats().*/
+	WireStats _wireBase; /**<Server byte counters at the last resetWireStats().*/
+	vector<string> _uncommittedTables; /**<Tables written by the open transaction, invalidated again once it ends.*/
 	string _error; /**<String that stores any error messages that is encountered*/
 
+	void clearResults();
+	bool discardPendingResults();
+	void release();
+	void notifyCache(const char* query, size_t length);
+	QueryTimer startTimer(const char* query, size_t length);
+	void countResultBytes(MYSQL_RES* res);
+	void countHeaderBytes(MYSQL_RES* res);
+	void countRowBytes(MYSQL_ROW row, const unsigned long* lengths, unsigned int num_fields);
+	bool readServerBytes(WireStats& stats);
+
 	public:
+	/**
+	 * Fills buffer with up to length bytes of LOAD DATA input.
+	 * Returns the number of bytes written, 0 once all data has been produced, or -1 to abort the load.
+	 */
+	using DataProducer = std::function<long(char* buffer, unsigned int length)>;
+
 	Connector(MYSQL* con = nullptr);
-	Connector(const Connector& con);
-	Connector& operator=(const Connector& rhs);
+	Connector(const Connector& con) = delete;
+	Connector& operator=(const Connector& rhs) = delete;
+	Connector(Connector&& con) noexcept;
+	Connector& operator=(Connector&& rhs) noexcept;
 	bool connect(const char* host, const char* user, const char* pass, const char* db, const unsigned& port, const char* uport, const unsigned long& flags);
+	bool connect(const ConnectionOptions& options);
+	bool reconnect(const ConnectionOptions& options);
+	bool setCompression(Compression compression, unsigned level = 3);
+	bool getWireStats(WireStats& stats);
+	bool resetWireStats();
 	bool query(const char* query);
+	bool query(const char* query, unsigned long length);
+	bool store(const char* query, Result& result);
+	bool stream(const char* query, Cursor& cursor);
+	bool queryColumnar(const char* query, ColumnarResult& result);
+	bool querySpillable(const char* query, SpillableResult& result);
+	bool prepare(const char* query, Statement& stmt);
+	Statement* prepareCached(const char* query);
+	bool batch(const char* statements, vector<Result>& results);
+	bool batch(const vector<string>& statements, vector<Result>& results);
+	bool loadLocalData(const char* statement, const DataProducer& producer);
+	bool queryCached(const char* query, std::shared_ptr<const Result>& result, QueryCache::clock::duration ttl = QueryCache::clock::duration::zero());
 	template <typename... Args>
 	bool query(const char* q, const Args*... args);
+	template <typename T>
+	bool queryAs(const char* query, vector<T>& rows);
 	inline bool isDefinitionStatement() const {return _definitionStatement;}
-	inline bool isLibraryInitialized() const {return _lib_initialized;}
-	inline bool MYSQL_lib_failed() const {return _lib_failed;}
+	inline bool isLibraryInitialized() const {return _runtime.isInitialized();}
+	inline bool MYSQL_lib_failed() const {return _runtime.hasFailed();}
 	inline bool isConnected() const {return _connected;}
 	inline string getError() const {return _error;}
 	inline my_ulonglong getNumAffectedRows() const {return _affectedRows;}
 	inline int getNumFields() const {return _num_fields;}
-	//inline vector<vector<boost::any> > getData() const {return _data;} <-- Accessor that returns 2D std::vector of boost::any that possibly houses retrieved data.
-	inline vector<vector<any> > getData() const {return _data;}
-	inline vector<string> getFieldNames() const {return _fieldNames;}
-	inline MYSQL* getMYSQL_Ptr() const {return _con;}
-	inline MYSQL_RES* getMYSQL_RES_Ptr() const {return _res;}
+	//const vector<vector<boost::any> >& getData() const; <-- Accessor that returns 2D std::vector of boost::any that possibly houses retrieved data.
+	const vector<vector<any> >& getData() const;
+	inline size_t getNumRows() const {return _num_rows;}
+	inline bool isNull(size_t row, int field) const {return _cells[row * _num_fields + field].offset == NULL_CELL;}
+	inline string_view getCell(size_t row, int field) const {const Cell& c = _cells[row * _num_fields + field]; return c.offset == NULL_CELL ? string_view() : string_view(_arena.data() + c.offset, c.length);}
+	inline const char* getCString(size_t row, int field) const {const Cell& c = _cells[row * _num_fields + field]; return c.offset == NULL_CELL ? nullptr : _arena.data() + c.offset;}
+	inline const vector<string>& getFieldNames() const {return _fieldNames;}
+	inline StatementCache& getStatementCache() {return _statements;}
+	inline void setMetrics(QueryMetrics* metrics) {_metrics = metrics;}
+	inline QueryMetrics* getMetrics() const {return _metrics;}
+	inline void setQueryCache(QueryCache* cache) {_queryCache = cache;}
+	inline QueryCache* getQueryCache() const {return _queryCache;}
+	inline void setRecorder(QueryRecorder* recorder) {_recorder = recorder;}
+	inline QueryRecorder* getRecorder() const {return _recorder;}
+	inline void setWireAccounting(bool enable) {_countWireBytes = enable;}
+	inline bool isWireAccounting() const {return _countWireBytes;}
+	inline MYSQL* getMYSQL_Ptr() const {return _con.get();}
+	inline MYSQL_RES* getMYSQL_RES_Ptr() const {return _res.get();}
 	inline MYSQL_FIELD* getMYSQL_FIELD_Ptr() const {return _field;}
 	inline MYSQL_ROW getMYSQL_ROW_Struct() const {return _row;}
 	~Connector();
@@ -88,4 +238,101 @@ bool Connector::query(const char* q,const Args*... args)
 	return query(args ...);
 }
 
+/**
+ * Used to execute a query and decode every row straight into T, with no std::any and no per-cell type dispatch.
+ * T is a std::tuple, a struct declaring its members with CONNECTOR_ROW, or a single value for one column results;
+ * its elements may be integers, bool, float, double, std::string or std::optional of those for nullable columns.
+ * The column count and the MYSQL_FIELD types are checked against T once, then rows are decoded as they come off the
+ * socket without being buffered by the client library. getData() is left empty.
+ * @param query stores query in a const char* to be executed on target database.
+ * @param rows Receives one T per row. T must be default constructible.
+ * @return If query was successfully executed and every row decoded or not.
+ */
+template <typename T>
+bool Connector::queryAs(const char* query, vector<T>& rows)
+{
+	clearResults();
+	rows.clear();
+	QueryTimer timer = startTimer(query,std::strlen(query));
+	if(mysql_query(_con.get(),query))
+	{
+		_error = mysql_error(_con.get());
+		timer.finish(false);
+		return false;
+	}
+	timer.lap(QueryMetrics::ROUND_TRIP);
+	notifyCache(query,std::strlen(query));
+
+	ResultHandle res(mysql_use_result(_con.get()));
+	if(!res)
+	{
+		if(mysql_field_count(_con.get()) != 0)
+		{
+			_error = mysql_error(_con.get());
+			timer.finish(false);
+			return false;
+		}
+		if(_countWireBytes)
+		{
+			countResultBytes(nullptr);
+		}
+		_definitionStatement = true;
+		_affectedRows = mysql_affected_rows(_con.get());
+		bool rval = discardPendingResults();
+		timer.finish(rval);
+		return rval;
+	}
+
+	// Freeing an unbuffered result reads whatever rows are left, so every early return leaves the connection usable.
+	_definitionStatement = false;
+	_num_fields = static_cast<int>(mysql_num_fields(res.get()));
+	MYSQL_FIELD* fields = mysql_fetch_fields(res.get());
+	for(int i = 0; i < _num_fields; i++)
+	{
+		_fieldNames.push_back(fields[i].name);
+	}
+	if(!RowMapper<T>::check(fields,static_cast<unsigned int>(_num_fields),_error))
+	{
+		res.reset();
+		discardPendingResults();
+		timer.finish(false);
+		return false;
+	}
+
+	// The rows are not buffered, so their raw size is added up as they arrive.
+	if(_countWireBytes)
+	{
+		countHeaderBytes(res.get());
+	}
+	MYSQL_ROW row;
+	while((row = mysql_fetch_row(res.get())))
+	{
+		if(_countWireBytes)
+		{
+			countRowBytes(row,mysql_fetch_lengths(res.get()),static_cast<unsigned int>(_num_fields));
+		}
+		rows.emplace_back();
+		if(!RowMapper<T>::decode(row,mysql_fetch_lengths(res.get()),rows.back(),_error))
+		{
+			_error = "Row " + std::to_string(rows.size() - 1) + ": " + _error;
+			rows.pop_back();
+			res.reset();
+			discardPendingResults();
+			timer.finish(false,rows.size());
+			return false;
+		}
+	}
+	if(mysql_errno(_con.get()))
+	{
+		_error = mysql_error(_con.get());
+		timer.finish(false,rows.size());
+		return false;
+	}
+	res.reset();
+	timer.lap(QueryMetrics::MATERIALIZE);
+	bool rval = discardPendingResults();
+	timer.finish(rval,rows.size());
+	return rval;
+}
+
 #endif // CONNECTOR_H
@@ -0,0 +1,155 @@
+/**
+ *
+ * @file cursor.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector streaming cursor source file
+ */
+
+#include "cursor.h"
+
+#include <utility> /**Library needed to use std::exchange*/
+
+/**
+ * Move Constructor
+ * @param cursor Cursor whose open result set is taken over.
+ */
+Cursor::Cursor(Cursor&& cursor) noexcept :
+	_con{std::exchange(cursor._con, nullptr)},
+	_res{std::move(cursor._res)},
+	_row{std::exchange(cursor._row, nullptr)},
+	_lengths{std::exchange(cursor._lengths, nullptr)},
+	_num_fields{std::exchange(cursor._num_fields, 0)},
+	_rowsFetched{std::exchange(cursor._rowsFetched, 0)},
+	_started{std::exchange(cursor._started, false)},
+	_fieldNames{std::move(cursor._fieldNames)},
+	_error{std::move(cursor._error)}
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs Cursor whose open result set is taken over.
+ * @return The current object after the move has been complete.
+ */
+Cursor& Cursor::operator=(Cursor&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		close();
+		_con = std::exchange(rhs._con, nullptr);
+		_res = std::move(rhs._res);
+		_row = std::exchange(rhs._row, nullptr);
+		_lengths = std::exchange(rhs._lengths, nullptr);
+		_num_fields = std::exchange(rhs._num_fields, 0);
+		_rowsFetched = std::exchange(rhs._rowsFetched, 0);
+		_started = std::exchange(rhs._started, false);
+		_fieldNames = std::move(rhs._fieldNames);
+		_error = std::move(rhs._error);
+	}
+	return *this;
+}
+
+/**
+ * Starts streaming the result of the query last sent on a connection.
+ * @param con Connection that has just had a query sent on it.
+ * @return If an unbuffered result set was opened or not. A statement that produces no result set returns false with no error.
+ */
+bool Cursor::open(MYSQL* con)
+{
+	close();
+	_error.clear();
+	_started = false;
+	_rowsFetched = 0;
+	_num_fields = 0;
+	_fieldNames.clear();
+	_con = con;
+	_res.reset(mysql_use_result(_con));
+	if(!_res)
+	{
+		if(mysql_field_count(_con) != 0)
+		{
+			_error = mysql_error(_con);
+		}
+		return false;
+	}
+
+	_num_fields = mysql_num_fields(_res.get());
+	MYSQL_FIELD* fields = mysql_fetch_fields(_res.get());
+	_fieldNames.reserve(_num_fields);
+	for(unsigned int i = 0; i < _num_fields; i++)
+	{
+		_fieldNames.push_back(fields[i].name);
+	}
+	return true;
+}
+
+/**
+ * Reads the next row off the socket, replacing the current row.
+ * @return If a row was read or not. Check getError() once this returns false to tell the end of the result set from a failure.
+ */
+bool Cursor::next()
+{
+	_started = true;
+	if(!_res)
+	{
+		return false;
+	}
+
+	_row = mysql_fetch_row(_res.get());
+	if(!_row)
+	{
+		if(mysql_errno(_con))
+		{
+			_error = mysql_error(_con);
+		}
+		close();
+		return false;
+	}
+	_lengths = mysql_fetch_lengths(_res.get());
+	_rowsFetched++;
+	return true;
+}
+
+/**
+ * Frees the result set. Any rows not yet read are drained off the socket by the client library, as are the results of
+ * any further statements sent in the same query, so the connection can be reused.
+ */
+void Cursor::close()
+{
+	if(_res.get())
+	{
+		_res.reset();
+		while(mysql_more_results(_con) && mysql_next_result(_con) == 0)
+		{
+			MYSQL_RES* res = mysql_store_result(_con);
+			if(res)
+			{
+				mysql_free_result(res);
+			}
+		}
+	}
+	_row = nullptr;
+	_lengths = nullptr;
+}
+
+/**
+ * Fetches the first row and returns an iterator positioned on it.
+ * @return Iterator on the first row, or end() when there are no rows.
+ */
+Cursor::iterator Cursor::begin()
+{
+	if(!_started)
+	{
+		return next() ? iterator(this) : end();
+	}
+	return _row ? iterator(this) : end();
+}
+
+/**
+ * Basic Destructor
+ */
+Cursor::~Cursor()
+{
+	close();
+}
@@ -0,0 +1,88 @@
+/**
+ *
+ * @file cursor.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Forward-only row cursor over an unbuffered (mysql_use_result) MySQL result set
+ */
+
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstddef> /**Library needed to use std::ptrdiff_t*/
+#include <iterator> /**Library needed to use std::input_iterator_tag*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include "handles.h" /**Header needed to use ResultHandle*/
+#include "row.h" /**Header needed to use Row*/
+
+/**
+ * Streams the rows of a result set straight off the socket, one at a time.
+ * Only the current row is held in client memory, so a result set of any size
+ * can be walked with a flat footprint. The owning connection can not run
+ * another query until the cursor has been exhausted or closed.
+ */
+class Cursor
+{
+	MYSQL* _con = nullptr; /**<Connection the unbuffered result set belongs to.*/
+	ResultHandle _res; /**<Unbuffered MySQL Results C structure.*/
+	MYSQL_ROW _row = nullptr; /**<Current MYSQL Row C Structure.*/
+	unsigned long* _lengths = nullptr; /**<Byte lengths of every cell in the current row.*/
+	unsigned int _num_fields = 0; /**<Used to store number of fields retrieved*/
+	my_ulonglong _rowsFetched = 0; /**<Number of rows read off the socket so far.*/
+	bool _started = false; /**<Boolean that stores if the first row has been requested yet.*/
+	vector<string> _fieldNames; /**<Vector of std::string used to store field names retrieved.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	public:
+	/**
+	 * Single pass input iterator so a Cursor can drive a range-based for loop.
+	 * Incrementing reads the next row off the socket; the previous row is gone.
+	 */
+	class iterator
+	{
+		Cursor* _cursor = nullptr; /**<Cursor being walked, nullptr once exhausted.*/
+
+		public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Row;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Row;
+
+		iterator(Cursor* cursor = nullptr) : _cursor(cursor) {}
+		inline Row operator*() const {return _cursor->getRow();}
+		inline iterator& operator++() {if(!_cursor->next()) _cursor = nullptr; return *this;}
+		inline bool operator==(const iterator& rhs) const {return _cursor == rhs._cursor;}
+		inline bool operator!=(const iterator& rhs) const {return _cursor != rhs._cursor;}
+	};
+
+	Cursor() = default;
+	Cursor(const Cursor& cursor) = delete;
+	Cursor& operator=(const Cursor& rhs) = delete;
+	Cursor(Cursor&& cursor) noexcept;
+	Cursor& operator=(Cursor&& rhs) noexcept;
+	bool open(MYSQL* con);
+	bool next();
+	void close();
+	iterator begin();
+	inline iterator end() {return iterator();}
+	inline bool isOpen() const {return _res != nullptr;}
+	inline string getError() const {return _error;}
+	inline int getNumFields() const {return _num_fields;}
+	inline my_ulonglong getNumRowsFetched() const {return _rowsFetched;}
+	inline const vector<string>& getFieldNames() const {return _fieldNames;}
+	inline Row getRow() const {return Row(_row, _lengths, _num_fields);}
+	inline MYSQL_ROW getMYSQL_ROW_Struct() const {return _row;}
+	inline const unsigned long* getLengths() const {return _lengths;}
+	~Cursor();
+};
+
+#endif // CURSOR_H
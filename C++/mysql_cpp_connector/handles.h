@@ -0,0 +1,44 @@
+/**
+ *
+ * @file handles.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief std::unique_ptr wrappers that release MySQL C structures automatically
+ */
+
+#ifndef HANDLES_H
+#define HANDLES_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <memory> /**Library needed to use std::unique_ptr*/
+
+/**
+ * Deleter that closes a connection.
+ */
+struct MysqlCloser
+{
+	inline void operator()(MYSQL* con) const {mysql_close(con);}
+};
+
+/**
+ * Deleter that frees a result set, draining any unread rows of an unbuffered one.
+ */
+struct ResultFreer
+{
+	inline void operator()(MYSQL_RES* res) const {mysql_free_result(res);}
+};
+
+/**
+ * Deleter that closes a prepared statement on the server.
+ */
+struct StatementCloser
+{
+	inline void operator()(MYSQL_STMT* stmt) const {mysql_stmt_close(stmt);}
+};
+
+using MysqlHandle = std::unique_ptr<MYSQL, MysqlCloser>; /**<Owning MYSQL pointer.*/
+using ResultHandle = std::unique_ptr<MYSQL_RES, ResultFreer>; /**<Owning MYSQL_RES pointer.*/
+using StatementHandle = std::unique_ptr<MYSQL_STMT, StatementCloser>; /**<Owning MYSQL_STMT pointer.*/
+
+#endif // HANDLES_H
@@ -0,0 +1,323 @@
+/**
+ *
+ * @file metrics.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector metrics source file
+ */
+
+#include "metrics.h"
+
+#include <cstdio> /**Library needed to use std::snprintf and std::rename*/
+#include <fstream> /**Library needed to use std::ofstream*/
+
+/**
+ * Bucket boundaries, in seconds, written out for the Prometheus histograms.
+ */
+static const double PROMETHEUS_BOUNDS[] = {0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+                                           0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+/**
+ * Finds a percentile of the recorded values.
+ * @param p Percentile to find, from 0 to 100.
+ * @return Upper bound of the bucket holding the percentile, in nanoseconds, never more than max. 0 when nothing was recorded.
+ */
+uint64_t HistogramSnapshot::percentile(double p) const
+{
+	if(count == 0)
+	{
+		return 0;
+	}
+	uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count) + 0.5);
+	if(target == 0)
+	{
+		target = 1;
+	}
+	uint64_t seen = 0;
+	for(size_t i = 0; i < buckets.size(); i++)
+	{
+		seen += buckets[i];
+		if(seen >= target)
+		{
+			uint64_t upper = LatencyHistogram::bucketUpperBound(i);
+			return upper < max ? upper : max;
+		}
+	}
+	return max;
+}
+
+/**
+ * Counts the values recorded in buckets up to and including the one value falls in.
+ * @param value Bound in nanoseconds.
+ * @return Number of values at or below value, to the histogram's precision.
+ */
+uint64_t HistogramSnapshot::countAtOrBelow(uint64_t value) const
+{
+	size_t last = LatencyHistogram::bucketIndex(value);
+	uint64_t total = 0;
+	for(size_t i = 0; i <= last && i < buckets.size(); i++)
+	{
+		total += buckets[i];
+	}
+	return total;
+}
+
+/**
+ * Basic Constructor
+ */
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+/**
+ * Adds a value to the histogram. Safe to call from any number of threads at once.
+ * @param nanoseconds Value to record. Values past the largest bucket land in the largest bucket.
+ */
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+	_buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+	uint64_t max = _max.load(std::memory_order_relaxed);
+	while(nanoseconds > max && !_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+/**
+ * Zeroes every bucket and total.
+ */
+void LatencyHistogram::reset()
+{
+	for(std::atomic<uint64_t>& bucket : _buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Copies the histogram. Values recorded while the copy is taken may or may not be included.
+ * @return Copy of every bucket and total.
+ */
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+	HistogramSnapshot snapshot;
+	snapshot.buckets.resize(NUM_BUCKETS);
+	for(size_t i = 0; i < NUM_BUCKETS; i++)
+	{
+		snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[i];
+	}
+	snapshot.sum = _sum.load(std::memory_order_relaxed);
+	snapshot.max = _max.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+/**
+ * Finds the bucket a value is counted in.
+ * @param value Value in nanoseconds.
+ * @return Index of the bucket.
+ */
+size_t LatencyHistogram::bucketIndex(uint64_t value)
+{
+	if(value < SUB_BUCKETS)
+	{
+		return static_cast<size_t>(value);
+	}
+	unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+	if(msb > MAX_BIT)
+	{
+		return NUM_BUCKETS - 1;
+	}
+	size_t group = msb - SUB_BUCKET_BITS + 1;
+	size_t sub = static_cast<size_t>(value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+	return group * SUB_BUCKETS + sub;
+}
+
+/**
+ * Smallest value counted in a bucket.
+ * @param index Index of the bucket.
+ * @return Lower bound in nanoseconds.
+ */
+uint64_t LatencyHistogram::bucketLowerBound(size_t index)
+{
+	if(index < SUB_BUCKETS)
+	{
+		return index;
+	}
+	size_t group = index / SUB_BUCKETS;
+	size_t sub = index % SUB_BUCKETS;
+	return static_cast<uint64_t>(SUB_BUCKETS + sub) << (group - 1);
+}
+
+/**
+ * Largest value counted in a bucket.
+ * @param index Index of the bucket.
+ * @return Upper bound in nanoseconds.
+ */
+uint64_t LatencyHistogram::bucketUpperBound(size_t index)
+{
+	if(index < SUB_BUCKETS)
+	{
+		return index;
+	}
+	size_t group = index / SUB_BUCKETS;
+	return bucketLowerBound(index) + (uint64_t(1) << (group - 1)) - 1;
+}
+
+/**
+ * Records how long one phase of a query took.
+ * @param phase Phase that finished.
+ * @param nanoseconds Duration of the phase.
+ */
+void QueryMetrics::recordPhase(Phase phase, uint64_t nanoseconds)
+{
+	switch(phase)
+	{
+		case ROUND_TRIP:
+			roundTrip.record(nanoseconds);
+			break;
+		case TRANSFER:
+			transfer.record(nanoseconds);
+			break;
+		case MATERIALIZE:
+			materialize.record(nanoseconds);
+			break;
+	}
+}
+
+/**
+ * Counts a finished query.
+ * @param ok If the query succeeded or not.
+ * @param rows Rows it retrieved.
+ * @param bytes Cell bytes it retrieved.
+ */
+void QueryMetrics::recordQuery(bool ok, uint64_t rows, uint64_t bytes)
+{
+	_queries.fetch_add(1, std::memory_order_relaxed);
+	if(!ok)
+	{
+		_errors.fetch_add(1, std::memory_order_relaxed);
+	}
+	_rows.fetch_add(rows, std::memory_order_relaxed);
+	_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * Zeroes every counter and histogram.
+ */
+void QueryMetrics::reset()
+{
+	_queries.store(0, std::memory_order_relaxed);
+	_errors.store(0, std::memory_order_relaxed);
+	_rows.store(0, std::memory_order_relaxed);
+	_bytes.store(0, std::memory_order_relaxed);
+	roundTrip.reset();
+	transfer.reset();
+	materialize.reset();
+}
+
+/**
+ * Copies every counter and histogram.
+ * @return Point in time copy of the metrics.
+ */
+MetricsSnapshot QueryMetrics::snapshot() const
+{
+	MetricsSnapshot snapshot;
+	snapshot.queries = _queries.load(std::memory_order_relaxed);
+	snapshot.errors = _errors.load(std::memory_order_relaxed);
+	snapshot.rows = _rows.load(std::memory_order_relaxed);
+	snapshot.bytes = _bytes.load(std::memory_order_relaxed);
+	snapshot.roundTrip = roundTrip.snapshot();
+	snapshot.transfer = transfer.snapshot();
+	snapshot.materialize = materialize.snapshot();
+	return snapshot;
+}
+
+/**
+ * Appends one histogram in Prometheus text format.
+ * @param out Text being built.
+ * @param name Full metric name.
+ * @param help Description of the metric.
+ * @param histogram Histogram to write.
+ */
+static void appendHistogram(string& out, const string& name, const char* help, const HistogramSnapshot& histogram)
+{
+	char line[256];
+	out += "# HELP " + name + " " + help + "\n";
+	out += "# TYPE " + name + " histogram\n";
+	for(double bound : PROMETHEUS_BOUNDS)
+	{
+		std::snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", name.c_str(), bound,
+		              static_cast<unsigned long long>(histogram.countAtOrBelow(static_cast<uint64_t>(bound * 1e9))));
+		out += line;
+	}
+	std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n",
+	              name.c_str(), static_cast<unsigned long long>(histogram.count),
+	              name.c_str(), static_cast<double>(histogram.sum) / 1e9,
+	              name.c_str(), static_cast<unsigned long long>(histogram.count));
+	out += line;
+}
+
+/**
+ * Appends one counter in Prometheus text format.
+ * @param out Text being built.
+ * @param name Full metric name.
+ * @param help Description of the metric.
+ * @param value Value of the counter.
+ */
+static void appendCounter(string& out, const string& name, const char* help, uint64_t value)
+{
+	out += "# HELP " + name + " " + help + "\n";
+	out += "# TYPE " + name + " counter\n";
+	out += name + " " + std::to_string(value) + "\n";
+}
+
+/**
+ * Renders a snapshot in the Prometheus text exposition format.
+ * @param snapshot Metrics to render.
+ * @param prefix Prefix of every metric name.
+ * @return The metrics as Prometheus text.
+ */
+string QueryMetrics::formatPrometheus(const MetricsSnapshot& snapshot, const char* prefix)
+{
+	string p(prefix);
+	string out;
+	appendCounter(out, p + "_queries_total", "Statements executed.", snapshot.queries);
+	appendCounter(out, p + "_query_errors_total", "Statements that failed.", snapshot.errors);
+	appendCounter(out, p + "_rows_total", "Rows retrieved.", snapshot.rows);
+	appendCounter(out, p + "_bytes_total", "Cell bytes retrieved.", snapshot.bytes);
+	appendHistogram(out, p + "_round_trip_seconds", "Time from sending a statement until the server answered.", snapshot.roundTrip);
+	appendHistogram(out, p + "_transfer_seconds", "Time spent reading buffered result sets off the socket.", snapshot.transfer);
+	appendHistogram(out, p + "_materialize_seconds", "Time spent copying or indexing rows.", snapshot.materialize);
+	return out;
+}
+
+/**
+ * Writes a snapshot of the metrics to a file in Prometheus text format, for example for the node exporter textfile collector.
+ * The file is written under a temporary name and renamed into place so readers never see half of it.
+ * @param path File to write.
+ * @param prefix Prefix of every metric name.
+ * @return If the file was written or not.
+ */
+bool QueryMetrics::writePrometheus(const char* path, const char* prefix) const
+{
+	string tmp = string(path) + ".tmp";
+	{
+		std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+		if(!out)
+		{
+			return false;
+		}
+		out << formatPrometheus(snapshot(), prefix);
+		if(!out)
+		{
+			return false;
+		}
+	}
+	return std::rename(tmp.c_str(), path) == 0;
+}
@@ -0,0 +1,310 @@
+/**
+ *
+ * @file parallel_scan.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector parallel scan source file
+ */
+
+#include "parallel_scan.h"
+
+#include <algorithm> /**Library needed to use std::min and std::find*/
+#include <atomic> /**Library needed to use std::atomic*/
+#include <charconv> /**Library needed to use std::from_chars*/
+#include <mutex> /**Library needed to use std::mutex*/
+#include <thread> /**Library needed to use std::thread*/
+
+#include "cursor.h" /**Header needed to use Cursor*/
+#include "runtime.h" /**Header needed to use ThreadScope*/
+
+/**
+ * Reads one integer cell of a MIN/MAX row.
+ * @return If the cell held an integer or not.
+ */
+static bool parseKey(string_view cell, int64_t& out)
+{
+	std::from_chars_result parsed = std::from_chars(cell.data(), cell.data() + cell.size(), out);
+	return !cell.empty() && parsed.ec == std::errc() && parsed.ptr == cell.data() + cell.size();
+}
+
+/**
+ * Runs work(partition, connector) for every partition on min(partitions, pool size) threads, each borrowing one
+ * connection for as long as there are partitions left to take. A connection that no longer answers after a partition
+ * failed is opened again before it reads the next one.
+ */
+template <typename Work>
+static void forEachPartition(ConnectionPool& pool, vector<ParallelScan::Partition>& partitions, const Work& work)
+{
+	std::atomic<size_t> next{0};
+	size_t threads = std::min(partitions.size(), pool.getSize());
+	vector<std::thread> workers;
+	workers.reserve(threads);
+	for(size_t t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&pool, &partitions, &work, &next]()
+		{
+			ThreadScope scope;
+			ConnectionPool::Handle con = pool.acquire();
+			for(size_t i = next++; i < partitions.size(); i = next++)
+			{
+				if(!con)
+				{
+					partitions[i].error = "The connection pool is closed.";
+					continue;
+				}
+				work(i, *con);
+				if(!partitions[i].error.empty() && mysql_ping(con->getMYSQL_Ptr()) != 0)
+				{
+					con->reconnect(pool.getOptions());
+				}
+			}
+		});
+	}
+	for(std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+/**
+ * Basic Constructor
+ * @param pool Pool the slices borrow their connections from. It must stay open for as long as a scan runs.
+ * @param table Table to scan, optionally qualified with its database (db.table).
+ * @param keyColumn Integer column to split the key range on, usually the primary key.
+ * @param partitions Number of slices to cut the key range into.
+ */
+ParallelScan::ParallelScan(ConnectionPool& pool, const string& table, const string& keyColumn, size_t partitions) :
+	_pool(&pool),
+	_table(table),
+	_keyColumn(keyColumn),
+	_num_partitions(partitions ? partitions : 1)
+{
+}
+
+/**
+ * Quotes a possibly database-qualified name with backticks so it can be put into a query.
+ * @param name Name such as orders or shop.orders.
+ * @return The quoted name such as `shop`.`orders`.
+ */
+string ParallelScan::quoteIdentifier(const string& name)
+{
+	string quoted = "`";
+	for(char c : name)
+	{
+		if(c == '.')
+		{
+			quoted += "`.`";
+		}
+		else
+		{
+			quoted += c;
+			if(c == '`')
+			{
+				quoted += '`';
+			}
+		}
+	}
+	quoted += '`';
+	return quoted;
+}
+
+/**
+ * Looks up the key range and cuts it into slices. An empty table gets no slices.
+ * @param con Connection to run the lookup on.
+ * @return If the range was read or not.
+ */
+bool ParallelScan::plan(Connector& con)
+{
+	_partitions.clear();
+	string sql = "SELECT MIN(" + quoteIdentifier(_keyColumn) + "), MAX(" + quoteIdentifier(_keyColumn) + ") FROM " + quoteIdentifier(_table);
+	if(!_filter.empty())
+	{
+		sql += " WHERE (" + _filter + ")";
+	}
+	Result range;
+	if(!con.store(sql.c_str(), range))
+	{
+		_error = con.getError();
+		return false;
+	}
+	if(range.empty() || range.isNull(0, 0))
+	{
+		return true;
+	}
+	int64_t low, high;
+	if(!parseKey(range.cell(0, 0), low) || !parseKey(range.cell(0, 1), high))
+	{
+		_error = "Key column " + _keyColumn + " does not hold integers.";
+		return false;
+	}
+
+	// Unsigned arithmetic keeps the full int64 range from overflowing; width is the range size divided by the
+	// number of slices, rounded up.
+	uint64_t span = static_cast<uint64_t>(high) - static_cast<uint64_t>(low);
+	uint64_t width = span / _num_partitions + 1;
+	for(uint64_t offset = 0; ; offset += width)
+	{
+		Partition partition;
+		partition.low = static_cast<int64_t>(static_cast<uint64_t>(low) + offset);
+		partition.high = span - offset < width ? high : static_cast<int64_t>(static_cast<uint64_t>(partition.low) + width - 1);
+		_partitions.push_back(partition);
+		if(partition.high == high)
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Builds the query reading one slice.
+ * @param partition Slice to read.
+ * @return The query.
+ */
+string ParallelScan::sliceQuery(const Partition& partition) const
+{
+	string sql = "SELECT " + _columns + " FROM " + quoteIdentifier(_table) + " WHERE " + quoteIdentifier(_keyColumn) +
+	             " BETWEEN " + std::to_string(partition.low) + " AND " + std::to_string(partition.high);
+	if(!_filter.empty())
+	{
+		sql += " AND (" + _filter + ")";
+	}
+	return sql;
+}
+
+/**
+ * Copies the error of the first failed slice into _error.
+ * @return If every slice succeeded or not.
+ */
+bool ParallelScan::collectErrors()
+{
+	for(size_t i = 0; i < _partitions.size(); i++)
+	{
+		if(!_partitions[i].error.empty())
+		{
+			_error = "Partition " + std::to_string(i) + ": " + _partitions[i].error;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Scans the table, streaming every slice with a Cursor so no slice is ever held in memory.
+ * Rows of one slice arrive in the order the server sends them; slices arrive interleaved. When the callback stops the
+ * scan, the slices still streaming are ended with KILL QUERY from a separate connection, since closing their Cursors
+ * would otherwise read the rest of every slice.
+ * @param callback Called for every row on the thread of its slice; it must be safe to call from several threads at once.
+ * @return If every slice was read, or the callback stopped the scan, without an error.
+ */
+bool ParallelScan::run(const RowCallback& callback)
+{
+	_error.clear();
+	{
+		ConnectionPool::Handle con = _pool->acquire();
+		if(!con)
+		{
+			_error = "The connection pool is closed.";
+			return false;
+		}
+		if(!plan(*con))
+		{
+			return false;
+		}
+	}
+
+	std::atomic<bool> stopped{false};
+	std::mutex mutex; // Guards running, and stopped being set.
+	vector<unsigned long> running; // Server thread ids of the connections streaming a slice.
+	auto stop = [this, &stopped, &mutex, &running]()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(stopped.exchange(true) || running.empty())
+		{
+			return;
+		}
+		Connector killer;
+		if(killer.connect(_pool->getOptions()))
+		{
+			for(unsigned long id : running)
+			{
+				killer.query(("KILL QUERY " + std::to_string(id)).c_str());
+			}
+		}
+	};
+
+	forEachPartition(*_pool, _partitions, [this, &callback, &stopped, &mutex, &running, &stop](size_t i, Connector& con)
+	{
+		Partition& partition = _partitions[i];
+		unsigned long id = mysql_thread_id(con.getMYSQL_Ptr());
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(stopped)
+			{
+				return;
+			}
+			running.push_back(id);
+		}
+		Cursor cursor;
+		bool ok = con.stream(sliceQuery(partition).c_str(), cursor);
+		if(ok)
+		{
+			for(Row row : cursor)
+			{
+				partition.rows++;
+				if(!callback(i, row) || stopped)
+				{
+					stop();
+					break;
+				}
+			}
+		}
+		cursor.close();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			running.erase(std::find(running.begin(), running.end(), id));
+		}
+		// A killed slice fails with "Query execution was interrupted", which is not an error of the scan.
+		if(!stopped)
+		{
+			partition.error = ok ? cursor.getError() : con.getError();
+		}
+	});
+	return collectErrors();
+}
+
+/**
+ * Scans the table, storing every slice in a Result of its own.
+ * @param results Receives one Result per slice, ordered by key range like getPartitions().
+ * @return If every slice was read or not.
+ */
+bool ParallelScan::run(vector<Result>& results)
+{
+	_error.clear();
+	results.clear();
+	{
+		ConnectionPool::Handle con = _pool->acquire();
+		if(!con)
+		{
+			_error = "The connection pool is closed.";
+			return false;
+		}
+		if(!plan(*con))
+		{
+			return false;
+		}
+	}
+
+	results.resize(_partitions.size());
+	forEachPartition(*_pool, _partitions, [this, &results](size_t i, Connector& con)
+	{
+		Partition& partition = _partitions[i];
+		if(!con.store(sliceQuery(partition).c_str(), results[i]))
+		{
+			partition.error = con.getError();
+			return;
+		}
+		partition.rows = results[i].getNumRows();
+	});
+	return collectErrors();
+}
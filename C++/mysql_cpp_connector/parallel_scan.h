@@ -0,0 +1,86 @@
+/**
+ *
+ * @file parallel_scan.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Range-partitioned table scans run concurrently over the connections of a pool
+ */
+
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::int64_t*/
+#include <functional> /**Library needed to use std::function*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include "connection_pool.h" /**Header needed to use ConnectionPool*/
+#include "result.h" /**Header needed to use Result*/
+#include "row.h" /**Header needed to use Row*/
+
+/**
+ * Reads a whole table over several connections at once. The range of an integer key column (usually the primary key)
+ * is looked up with MIN/MAX and cut into equally wide slices, and every slice is read by its own thread on a
+ * connection borrowed from a ConnectionPool:
+ *
+ *     SELECT <columns> FROM <table> WHERE <key> BETWEEN <low> AND <high> [AND (<filter>)]
+ *
+ * At most as many slices run at once as the pool has connections; the rest wait for one to be returned. Slices are as
+ * wide as each other, not as full, so gaps in the key leave some of them lighter than others; asking for a few more
+ * slices than there are connections evens the work out.
+ *
+ * Every slice runs in its own transaction on its own connection, so the scan is not one consistent snapshot of the
+ * table. Rows changed while it runs may be seen in their old or new state, and keys inserted above the MAX looked up
+ * at the start are not read.
+ */
+class ParallelScan
+{
+	public:
+	/**
+	 * Called for every row, on the thread of the slice it belongs to; calls for different slices run at the same time.
+	 * Returning false stops the whole scan; the slices still running are cut short with KILL QUERY.
+	 */
+	using RowCallback = std::function<bool(size_t partition, const Row& row)>;
+
+	/**
+	 * One slice of the key range.
+	 */
+	struct Partition
+	{
+		int64_t low = 0; /**<Smallest key of the slice.*/
+		int64_t high = 0; /**<Largest key of the slice.*/
+		my_ulonglong rows = 0; /**<Number of rows read.*/
+		string error; /**<Why the slice failed, empty when it did not.*/
+	};
+
+	private:
+	ConnectionPool* _pool; /**<Pool the slices borrow their connections from.*/
+	string _table; /**<Table being scanned, optionally qualified with its database.*/
+	string _keyColumn; /**<Integer column the key range is split on.*/
+	size_t _num_partitions; /**<Number of slices requested.*/
+	string _columns = "*"; /**<Select list of every slice.*/
+	string _filter; /**<Extra condition every row must meet, empty for none.*/
+	vector<Partition> _partitions; /**<Slices of the last scan.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	bool plan(Connector& con);
+	string sliceQuery(const Partition& partition) const;
+	bool collectErrors();
+
+	public:
+	ParallelScan(ConnectionPool& pool, const string& table, const string& keyColumn, size_t partitions);
+	bool run(const RowCallback& callback);
+	bool run(vector<Result>& results);
+	static string quoteIdentifier(const string& name);
+	inline void setColumns(const string& columns) {_columns = columns;}
+	inline void setFilter(const string& filter) {_filter = filter;}
+	inline const vector<Partition>& getPartitions() const {return _partitions;}
+	inline string getError() const {return _error;}
+};
+
+#endif // PARALLEL_SCAN_H
@@ -0,0 +1,486 @@
+/**
+ *
+ * @file query_cache.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector query cache source file
+ */
+
+#include "query_cache.h"
+
+#include "sql_lexer.h" /**Header needed to use Lexer*/
+
+#include <algorithm> /**Library needed to use std::find*/
+#include <cctype> /**Library needed to use std::isspace and std::tolower*/
+#include <iterator> /**Library needed to use std::prev*/
+
+namespace
+{
+	using sql::Lexer;
+	using sql::Token;
+	using sql::isOneOf;
+
+	/**
+	 * Words after which a table name follows.
+	 */
+	const string_view TABLE_KEYWORDS[] = {"from", "join", "straight_join", "update", "into", "table", "truncate"};
+
+	/**
+	 * Modifiers that may sit between a TABLE_KEYWORDS word and the table name.
+	 */
+	const string_view TABLE_MODIFIERS[] = {"table", "ignore", "low_priority", "delayed", "high_priority", "quick", "only"};
+
+	/**
+	 * Words ending a comma separated list of tables.
+	 */
+	const string_view CLAUSE_KEYWORDS[] = {"where", "on", "using", "set", "values", "value", "select", "group", "order", "limit",
+	                                      "having", "union", "partition", "window", "left", "right", "inner", "cross", "natural",
+	                                      "outer", "lock", "for", "with"};
+
+	/**
+	 * Words that make the result of a SELECT depend on more than the tables it reads, or make it do more than read.
+	 */
+	const string_view VOLATILE_WORDS[] = {"now", "sysdate", "rand", "uuid", "uuid_short", "curdate", "curtime", "current_date",
+	                                     "current_time", "current_timestamp", "localtime", "localtimestamp", "unix_timestamp",
+	                                     "utc_date", "utc_time", "utc_timestamp", "last_insert_id", "found_rows", "row_count",
+	                                     "connection_id", "user", "current_user", "session_user", "system_user", "database",
+	                                     "schema", "sleep", "get_lock", "release_lock", "is_free_lock", "is_used_lock",
+	                                     "benchmark", "sql_no_cache", "into", "for", "lock"};
+
+	/**
+	 * Turns a possibly quoted and schema qualified table name into the lower case bare name used as an index key.
+	 */
+	string tableKey(string_view name)
+	{
+		size_t dot = name.rfind('.');
+		if(dot != string_view::npos)
+		{
+			name.remove_prefix(dot + 1);
+		}
+		string key;
+		key.reserve(name.size());
+		for(char c : name)
+		{
+			if(c != '`')
+			{
+				key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+			}
+		}
+		return key;
+	}
+
+	/**
+	 * Checks if a statement only reads: a single SELECT, SHOW, EXPLAIN or DESCRIBE.
+	 */
+	bool isReadOnly(string_view sql)
+	{
+		Lexer lexer(sql);
+		Token token;
+		if(!lexer.next(token) || !token.word)
+		{
+			return false;
+		}
+		const string_view READ_KEYWORDS[] = {"select", "show", "explain", "describe", "desc"};
+		if(!isOneOf(token.text, READ_KEYWORDS))
+		{
+			return false;
+		}
+		while(lexer.next(token))
+		{
+			if(token.text == ";")
+			{
+				return !lexer.next(token);
+			}
+		}
+		return true;
+	}
+}
+
+/**
+ * Basic Constructor
+ * @param maxBytes Memory budget. Least recently used entries are evicted once the estimated size of all entries passes it.
+ * @param ttl How long entries are served when put without a TTL of their own.
+ */
+QueryCache::QueryCache(size_t maxBytes, clock::duration ttl) :
+	_maxBytes(maxBytes),
+	_ttl(ttl)
+{
+}
+
+/**
+ * Looks a statement up.
+ * @param key Statement text as returned by normalize(), optionally followed by a null character and anything else
+ *            telling apart runs of the same text (Connector::queryCached adds the default database).
+ * @return The cached result, or nullptr when there is none or it has expired.
+ */
+std::shared_ptr<const Result> QueryCache::get(const string& key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto found = _entries.find(key);
+	if(found == _entries.end())
+	{
+		_stats.misses++;
+		return nullptr;
+	}
+	EntryList::iterator it = found->second;
+	if(clock::now() >= it->expires)
+	{
+		erase(it);
+		_stats.misses++;
+		return nullptr;
+	}
+	_lru.splice(_lru.begin(), _lru, it);
+	_stats.hits++;
+	return it->result;
+}
+
+/**
+ * Caches the result of a statement.
+ * @param key Statement text as returned by normalize(), optionally followed by a null character and more, see get().
+ * @param result Result of the statement. It must not be modified afterwards.
+ * @param generation Value of getGeneration() taken before the statement was sent. When a table was written since then
+ *                   the result may be stale and is not cached.
+ * @param ttl How long the entry is served, zero for the TTL the cache was constructed with.
+ * @return If the result was cached or not.
+ */
+bool QueryCache::put(const string& key, std::shared_ptr<const Result> result, uint64_t generation, clock::duration ttl)
+{
+	if(!result)
+	{
+		return false;
+	}
+	Entry entry;
+	entry.key = key;
+	entry.tables = referencedTables(key.c_str());
+	entry.bytes = estimateBytes(*result) + sizeof(Entry) + 2 * key.size();
+	for(const string& table : entry.tables)
+	{
+		entry.bytes += table.size();
+	}
+	entry.expires = clock::now() + (ttl == clock::duration::zero() ? _ttl : ttl);
+	entry.result = std::move(result);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(generation != _generation || entry.bytes > _maxBytes)
+	{
+		return false;
+	}
+	auto found = _entries.find(key);
+	if(found != _entries.end())
+	{
+		erase(found->second);
+	}
+	_lru.push_front(std::move(entry));
+	EntryList::iterator it = _lru.begin();
+	_entries.emplace(it->key, it);
+	for(const string& table : it->tables)
+	{
+		_byTable[table].insert(it->key);
+	}
+	_stats.bytes += it->bytes;
+	while(_stats.bytes > _maxBytes)
+	{
+		erase(std::prev(_lru.end()));
+		_stats.evictions++;
+	}
+	return true;
+}
+
+/**
+ * Drops the entries reading any table a statement may write. Single SELECT, SHOW, EXPLAIN and DESCRIBE statements are ignored.
+ * @param statement Statement that was run, multiple statements are allowed.
+ * @return The tables that were invalidated, lower case and without schema.
+ */
+vector<string> QueryCache::invalidate(string_view statement)
+{
+	if(isReadOnly(statement))
+	{
+		return vector<string>();
+	}
+	vector<string> tables = referencedTables(statement);
+	for(const string& table : tables)
+	{
+		invalidateTable(table);
+	}
+	return tables;
+}
+
+/**
+ * Drops every entry reading a table. Call it for writes the cache cannot see, like prepared statements or other processes.
+ * @param table Table name, optionally quoted or schema qualified.
+ */
+void QueryCache::invalidateTable(string_view table)
+{
+	string key = tableKey(table);
+	std::lock_guard<std::mutex> lock(_mutex);
+	_generation++;
+	auto found = _byTable.find(key);
+	if(found == _byTable.end())
+	{
+		return;
+	}
+	vector<string> keys(found->second.begin(), found->second.end());
+	for(const string& entry : keys)
+	{
+		auto it = _entries.find(entry);
+		if(it != _entries.end())
+		{
+			erase(it->second);
+			_stats.invalidations++;
+		}
+	}
+}
+
+/**
+ * Drops every entry.
+ */
+void QueryCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_generation++;
+	_lru.clear();
+	_entries.clear();
+	_byTable.clear();
+	_stats.bytes = 0;
+}
+
+/**
+ * Counter bumped by every invalidation, used by put() to refuse results read while a table was being written.
+ * @return The current generation.
+ */
+uint64_t QueryCache::getGeneration() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _generation;
+}
+
+/**
+ * Copies the usage counters.
+ * @return Usage counters of the cache.
+ */
+QueryCache::Stats QueryCache::getStats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Stats stats = _stats;
+	stats.entries = _entries.size();
+	return stats;
+}
+
+/**
+ * Removes an entry and every index pointing at it. _mutex must be held.
+ * @param it Entry to remove.
+ */
+void QueryCache::erase(EntryList::iterator it)
+{
+	for(const string& table : it->tables)
+	{
+		auto found = _byTable.find(table);
+		if(found != _byTable.end())
+		{
+			found->second.erase(it->key);
+			if(found->second.empty())
+			{
+				_byTable.erase(found);
+			}
+		}
+	}
+	_stats.bytes -= it->bytes;
+	_entries.erase(it->key);
+	_lru.erase(it);
+}
+
+/**
+ * Builds the cache key of a statement: runs of whitespace outside quotes become one space, -- and # comments are
+ * dropped (the key is one line, so they would swallow the rest of it), and surrounding whitespace and trailing
+ * semicolons are dropped. Block comments are kept as they are, optimizer hints live in them. Case is kept since table
+ * names can be case sensitive.
+ * @param sql Statement text.
+ * @return Normalized statement text.
+ */
+string QueryCache::normalize(string_view sql)
+{
+	string out;
+	out.reserve(sql.size());
+	char quote = 0;
+	bool space = false;
+	for(size_t i = 0; i < sql.size(); i++)
+	{
+		char c = sql[i];
+		if(quote)
+		{
+			out.push_back(c);
+			if(c == '\\' && quote != '`' && i + 1 < sql.size())
+			{
+				out.push_back(sql[++i]);
+			}
+			else if(c == quote)
+			{
+				quote = 0;
+			}
+			continue;
+		}
+		if(std::isspace(static_cast<unsigned char>(c)))
+		{
+			space = true;
+			continue;
+		}
+		if(c == '#' || (c == '-' && sql.compare(i, 2, "--") == 0 &&
+		                (i + 2 == sql.size() || std::isspace(static_cast<unsigned char>(sql[i + 2])))))
+		{
+			size_t end = sql.find('\n', i);
+			i = end == string_view::npos ? sql.size() : end;
+			space = true;
+			continue;
+		}
+		if(space && !out.empty())
+		{
+			out.push_back(' ');
+		}
+		space = false;
+		if(c == '/' && sql.compare(i, 2, "/*") == 0)
+		{
+			size_t end = sql.find("*/", i + 2);
+			end = end == string_view::npos ? sql.size() : end + 2;
+			out.append(sql.substr(i, end - i));
+			i = end - 1;
+			continue;
+		}
+		if(c == '\'' || c == '"' || c == '`')
+		{
+			quote = c;
+		}
+		out.push_back(c);
+	}
+	while(!out.empty() && (out.back() == ';' || out.back() == ' '))
+	{
+		out.pop_back();
+	}
+	return out;
+}
+
+/**
+ * Checks if the result of a statement may be cached: a single SELECT that does not lock rows, write into
+ * variables or files, or call functions whose result changes from call to call.
+ * @param sql Statement text.
+ * @return If the statement may be cached or not.
+ */
+bool QueryCache::isCacheable(string_view sql)
+{
+	Lexer lexer(sql);
+	Token token;
+	if(!lexer.next(token) || !token.word || !isOneOf(token.text, {"select"}))
+	{
+		return false;
+	}
+	while(lexer.next(token))
+	{
+		if(token.text == ";")
+		{
+			if(lexer.next(token))
+			{
+				return false;
+			}
+			break;
+		}
+		if(token.word && (token.text[0] == '@' || isOneOf(token.text, VOLATILE_WORDS)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Finds the tables a statement names after FROM, JOIN, UPDATE, INTO, TABLE or TRUNCATE, including every table of
+ * a comma separated list. Column names after ON DUPLICATE KEY UPDATE are picked up as well, which only means some
+ * extra entries get invalidated.
+ * @param sql Statement text, multiple statements are allowed.
+ * @return Table names, lower case and without schema or quotes, without duplicates.
+ */
+vector<string> QueryCache::referencedTables(string_view sql)
+{
+	enum State {NONE, EXPECT, LIST};
+	vector<string> tables;
+	State state = NONE;
+	int depth = 0;
+	int listDepth = 0;
+	Lexer lexer(sql);
+	Token token;
+	while(lexer.next(token))
+	{
+		if(token.word)
+		{
+			if(isOneOf(token.text, TABLE_KEYWORDS))
+			{
+				state = EXPECT;
+			}
+			else if(state == EXPECT)
+			{
+				if(isOneOf(token.text, TABLE_MODIFIERS))
+				{
+					continue;
+				}
+				string table = tableKey(token.text);
+				if(!table.empty() && std::find(tables.begin(), tables.end(), table) == tables.end())
+				{
+					tables.push_back(std::move(table));
+				}
+				state = LIST;
+				listDepth = depth;
+			}
+			else if(state == LIST && isOneOf(token.text, CLAUSE_KEYWORDS))
+			{
+				state = NONE;
+			}
+			continue;
+		}
+		switch(token.text[0])
+		{
+			case '(':
+				depth++;
+				if(state == EXPECT)
+				{
+					state = NONE;
+				}
+				break;
+			case ')':
+				depth--;
+				if(state == LIST && depth < listDepth)
+				{
+					state = NONE;
+				}
+				break;
+			case ',':
+				if(state == LIST && depth == listDepth)
+				{
+					state = EXPECT;
+				}
+				break;
+			case ';':
+				state = NONE;
+				break;
+		}
+	}
+	return tables;
+}
+
+/**
+ * Estimates the memory held by a Result: the cell bytes kept by the client library plus the row index built on top.
+ * @param result Result to measure.
+ * @return Estimated size in bytes.
+ */
+size_t QueryCache::estimateBytes(const Result& result)
+{
+	size_t fields = static_cast<size_t>(result.getNumFields());
+	size_t bytes = sizeof(Result) + fields * (sizeof(MYSQL_FIELD) + 64);
+	// Every row costs its pointer in the index and one past its last cell, every cell a pointer and a null character.
+	bytes += result.getNumRows() * (sizeof(MYSQL_ROW) + sizeof(char*) + fields * (sizeof(char*) + 1));
+	for(const Row& row : result)
+	{
+		for(unsigned int i = 0; i < row.size(); i++)
+		{
+			bytes += row[i].size();
+		}
+	}
+	return bytes;
+}
@@ -0,0 +1,101 @@
+/**
+ *
+ * @file query_cache.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Client-side cache of read-only query results with TTL, LRU eviction and write invalidation
+ */
+
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <chrono> /**Library needed to use std::chrono*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <list> /**Library needed to use std::list*/
+#include <memory> /**Library needed to use std::shared_ptr*/
+#include <mutex> /**Library needed to use std::mutex*/
+#include <unordered_map> /**Library needed to use std::unordered_map*/
+#include <unordered_set> /**Library needed to use std::unordered_set*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "result.h" /**Header needed to use Result*/
+
+/**
+ * Thread-safe cache of SELECT results shared by any number of Connectors (see Connector::setQueryCache and
+ * Connector::queryCached). Entries are keyed by the statement text with whitespace collapsed and the default
+ * database, expire after a TTL and are evicted least recently used first once their estimated size passes a memory
+ * budget. Any other statement run through a Connector using the cache drops every entry reading a table the statement
+ * names. Hits hand out the same immutable Result to every caller, nothing is copied.
+ */
+class QueryCache
+{
+	public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * Counters describing how the cache has been used.
+	 */
+	struct Stats
+	{
+		uint64_t hits = 0; /**<Lookups answered from the cache.*/
+		uint64_t misses = 0; /**<Lookups that found nothing or an expired entry.*/
+		uint64_t evictions = 0; /**<Entries dropped to stay within the memory budget.*/
+		uint64_t invalidations = 0; /**<Entries dropped because a table they read was written.*/
+		size_t entries = 0; /**<Entries currently cached.*/
+		size_t bytes = 0; /**<Estimated size of every cached entry.*/
+	};
+
+	private:
+	/**
+	 * One cached result.
+	 */
+	struct Entry
+	{
+		string key; /**<Normalized statement text.*/
+		std::shared_ptr<const Result> result; /**<Result handed out on a hit.*/
+		vector<string> tables; /**<Tables the statement reads, lower case and without schema.*/
+		clock::time_point expires; /**<When the entry stops being served.*/
+		size_t bytes = 0; /**<Estimated size of the entry.*/
+	};
+
+	using EntryList = std::list<Entry>;
+
+	EntryList _lru; /**<Every entry, most recently used first.*/
+	std::unordered_map<string, EntryList::iterator> _entries; /**<Entries by key.*/
+	std::unordered_map<string, std::unordered_set<string> > _byTable; /**<Keys of the entries reading each table.*/
+	size_t _maxBytes; /**<Memory budget of the cache.*/
+	clock::duration _ttl; /**<TTL of entries put without one of their own.*/
+	uint64_t _generation = 0; /**<Bumped by every invalidation.*/
+	Stats _stats; /**<Usage counters.*/
+	mutable std::mutex _mutex; /**<Guards everything above.*/
+
+	void erase(EntryList::iterator it);
+
+	public:
+	explicit QueryCache(size_t maxBytes = 64 * 1024 * 1024, clock::duration ttl = std::chrono::seconds(60));
+	QueryCache(const QueryCache& cache) = delete;
+	QueryCache& operator=(const QueryCache& rhs) = delete;
+	std::shared_ptr<const Result> get(const string& key);
+	bool put(const string& key, std::shared_ptr<const Result> result, uint64_t generation, clock::duration ttl = clock::duration::zero());
+	vector<string> invalidate(string_view statement);
+	void invalidateTable(string_view table);
+	void clear();
+	uint64_t getGeneration() const;
+	Stats getStats() const;
+	inline size_t getMaxBytes() const {return _maxBytes;}
+	static string normalize(string_view sql);
+	static bool isCacheable(string_view sql);
+	static vector<string> referencedTables(string_view sql);
+	static size_t estimateBytes(const Result& result);
+};
+
+#endif // QUERY_CACHE_H
@@ -0,0 +1,162 @@
+/**
+ *
+ * @file query_executor.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector asynchronous query executor source file
+ */
+
+#include "query_executor.h"
+
+#include <utility> /**Library needed to use std::move*/
+
+/**
+ * Connects one connection per worker and starts the workers.
+ * @param options Parameters every connection is opened with.
+ * @param workers Number of queries that can be in flight at once.
+ * @return If every connection was opened or not.
+ */
+bool QueryExecutor::open(const ConnectionOptions& options, size_t workers)
+{
+	close();
+	_error.clear();
+	if(!_pool.open(options, workers))
+	{
+		_error = _pool.getError();
+		return false;
+	}
+
+	_stopping = false;
+	_workers.reserve(workers);
+	for(size_t i = 0; i < workers; i++)
+	{
+		_workers.emplace_back(&QueryExecutor::workerLoop, this);
+	}
+	return true;
+}
+
+/**
+ * Queues a query and returns right away.
+ * @param sql Query to execute.
+ * @return Future that becomes ready with the Result once a worker has run the query.
+ */
+std::future<Result> QueryExecutor::queryAsync(string sql)
+{
+	Task task;
+	task.sql = std::move(sql);
+	std::future<Result> future = task.promise.get_future();
+	submit(std::move(task));
+	return future;
+}
+
+/**
+ * Queues a query and returns right away.
+ * @param sql Query to execute.
+ * @param callback Called on a worker thread with the Result once the query has run. It should not block for long, the worker waits for it.
+ */
+void QueryExecutor::queryAsync(string sql, Callback callback)
+{
+	Task task;
+	task.sql = std::move(sql);
+	task.callback = std::move(callback);
+	submit(std::move(task));
+}
+
+/**
+ * Hands a task to the workers, or fails it right away if the executor is not running.
+ * @param task Task to queue.
+ */
+void QueryExecutor::submit(Task&& task)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(!_stopping && !_workers.empty())
+		{
+			_tasks.push_back(std::move(task));
+			_pending.notify_one();
+			return;
+		}
+	}
+	Result result;
+	result.setError("QueryExecutor is not running.");
+	complete(task, result);
+}
+
+/**
+ * Delivers a result through the callback or the promise of its task.
+ * @param task Task that has finished.
+ * @param result Outcome of the task.
+ */
+void QueryExecutor::complete(Task& task, Result& result)
+{
+	if(task.callback)
+	{
+		task.callback(result);
+	}
+	else
+	{
+		task.promise.set_value(std::move(result));
+	}
+}
+
+/**
+ * Worker thread body: takes tasks off the queue until the executor stops and runs them on a pooled connection.
+ */
+void QueryExecutor::workerLoop()
+{
+	ThreadScope scope;
+	for(;;)
+	{
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_pending.wait(lock, [this]() {return _stopping || !_tasks.empty();});
+			if(_tasks.empty())
+			{
+				break;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+
+		Result result;
+		{
+			ConnectionPool::Handle con = _pool.acquire();
+			if(!con)
+			{
+				result.setError("No connection available.");
+			}
+			else
+			{
+				con->store(task.sql.c_str(), result);
+			}
+		}
+		complete(task, result);
+	}
+}
+
+/**
+ * Lets the workers finish every queued query, then stops them and closes their connections.
+ */
+void QueryExecutor::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_pending.notify_all();
+	for(std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+	_workers.clear();
+	_pool.close();
+}
+
+/**
+ * Basic Destructor
+ */
+QueryExecutor::~QueryExecutor()
+{
+	close();
+}
@@ -0,0 +1,76 @@
+/**
+ *
+ * @file query_executor.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Runs queries on background worker threads and hands back futures or completion callbacks
+ */
+
+#ifndef QUERY_EXECUTOR_H
+#define QUERY_EXECUTOR_H
+
+#include <condition_variable> /**Library needed to use std::condition_variable*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <deque> /**Library needed to use std::deque*/
+#include <functional> /**Library needed to use std::function*/
+#include <future> /**Library needed to use std::future and std::promise*/
+#include <mutex> /**Library needed to use std::mutex*/
+#include <thread> /**Library needed to use std::thread*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include "connection_pool.h" /**Header needed to use ConnectionPool*/
+#include "result.h" /**Header needed to use Result*/
+
+/**
+ * Owns a set of worker threads, each running queries on a connection of its own, so a caller can start several
+ * independent queries and keep working while the server answers them. Queries are picked up in the order they
+ * were submitted by whichever worker is free. A failed query is reported through the error of the Result, never
+ * through an exception.
+ */
+class QueryExecutor
+{
+	public:
+	using Callback = std::function<void(Result&)>;
+
+	private:
+	/**
+	 * A query waiting for a worker. Exactly one of promise or callback is used.
+	 */
+	struct Task
+	{
+		string sql; /**<Query to execute.*/
+		std::promise<Result> promise; /**<Fulfilled with the result when no callback was given.*/
+		Callback callback; /**<Called on the worker thread with the result.*/
+	};
+
+	ConnectionPool _pool; /**<One connection per worker.*/
+	vector<std::thread> _workers; /**<Threads executing queries.*/
+	std::deque<Task> _tasks; /**<Queries waiting for a worker.*/
+	std::mutex _mutex; /**<Guards _tasks and _stopping.*/
+	std::condition_variable _pending; /**<Signalled when a task is queued or the executor stops.*/
+	bool _stopping = false; /**<Boolean that stores if the executor is shutting down*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	void submit(Task&& task);
+	void workerLoop();
+	static void complete(Task& task, Result& result);
+
+	public:
+	QueryExecutor() = default;
+	QueryExecutor(const QueryExecutor& executor) = delete;
+	QueryExecutor& operator=(const QueryExecutor& rhs) = delete;
+	bool open(const ConnectionOptions& options, size_t workers);
+	std::future<Result> queryAsync(string sql);
+	void queryAsync(string sql, Callback callback);
+	void close();
+	inline size_t getNumWorkers() const {return _workers.size();}
+	inline string getError() const {return _error;}
+	~QueryExecutor();
+};
+
+#endif // QUERY_EXECUTOR_H
@@ -0,0 +1,279 @@
+/**
+ *
+ * @file query_recorder.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector query recorder source file
+ */
+
+#include "query_recorder.h"
+
+#include <cerrno> /**Library needed to use errno*/
+#include <cstring> /**Library needed to use std::memcmp and std::strerror*/
+
+const char QueryRecorder::MAGIC[8] = {'C', 'Q', 'L', 'O', 'G', '\0', '\0', '\1'};
+
+/**
+ * Appends an unsigned LEB128 varint.
+ */
+static void putVarint(string& out, uint64_t value)
+{
+	while(value >= 0x80)
+	{
+		out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Creates (or truncates) a capture log and writes its header.
+ * @param path File to write.
+ * @return If the log was opened or not.
+ */
+bool QueryRecorder::open(const string& path)
+{
+	close();
+	std::lock_guard<std::mutex> lock(_mutex);
+	_error.clear();
+	_file = std::fopen(path.c_str(), "wb");
+	if(!_file)
+	{
+		_error = "Could not open " + path + ": " + std::strerror(errno);
+		return false;
+	}
+	_buffer.assign(MAGIC, sizeof(MAGIC));
+	_buffer.reserve(BUFFER_BYTES + 4096);
+	_origin = clock::now();
+	_lastStart = 0;
+	_records = 0;
+	return true;
+}
+
+/**
+ * Appends a query. Does nothing while the log is closed.
+ * @param connectionId Server thread id of the connection that ran it.
+ * @param start When the query was sent.
+ * @param end When it finished.
+ * @param sql Statement text.
+ * @param ok If it succeeded.
+ */
+void QueryRecorder::record(uint64_t connectionId, clock::time_point start, clock::time_point end, string_view sql, bool ok)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_file)
+	{
+		return;
+	}
+	// Records are appended as queries finish, so start times are not in order and deltas can be negative.
+	int64_t startNs = start > _origin ? std::chrono::duration_cast<std::chrono::nanoseconds>(start - _origin).count() : 0;
+	int64_t delta = startNs - _lastStart;
+	_lastStart = startNs;
+	putVarint(_buffer, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+	putVarint(_buffer, connectionId);
+	putVarint(_buffer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+	putVarint(_buffer, (static_cast<uint64_t>(sql.size()) << 1) | (ok ? 1 : 0));
+	_buffer.append(sql.data(), sql.size());
+	_records++;
+	if(_buffer.size() >= BUFFER_BYTES)
+	{
+		writeBuffer();
+	}
+}
+
+/**
+ * Writes the gathered records to the file. The caller holds the mutex.
+ * @return If every byte was written or not.
+ */
+bool QueryRecorder::writeBuffer()
+{
+	if(!_buffer.empty() && std::fwrite(_buffer.data(), 1, _buffer.size(), _file) != _buffer.size())
+	{
+		_error = string("Could not write the capture log: ") + std::strerror(errno);
+		_buffer.clear();
+		return false;
+	}
+	_buffer.clear();
+	return true;
+}
+
+/**
+ * Writes every record gathered so far to disk.
+ * @return If every record was written or not.
+ */
+bool QueryRecorder::flush()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_file)
+	{
+		return true;
+	}
+	bool rval = writeBuffer();
+	return std::fflush(_file) == 0 && rval;
+}
+
+/**
+ * Writes every record gathered so far and closes the log. Recording stops until open() is called again.
+ * @return If every record was written or not.
+ */
+bool QueryRecorder::close()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_file)
+	{
+		return true;
+	}
+	bool rval = writeBuffer();
+	rval = std::fclose(_file) == 0 && rval;
+	_file = nullptr;
+	return rval;
+}
+
+/**
+ * Checks if the log is open.
+ * @return If queries are being recorded or not.
+ */
+bool QueryRecorder::isOpen()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _file != nullptr;
+}
+
+/**
+ * Counts the queries recorded since the log was opened.
+ * @return Number of records.
+ */
+uint64_t QueryRecorder::getNumRecords()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _records;
+}
+
+/**
+ * Returns the last error.
+ * @return The error, empty when there was none.
+ */
+string QueryRecorder::getError()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _error;
+}
+
+/**
+ * Basic Destructor
+ */
+QueryRecorder::~QueryRecorder()
+{
+	close();
+}
+
+/**
+ * Opens a capture log and checks its header.
+ * @param path File to read.
+ * @return If the file is a capture log or not.
+ */
+bool QueryLogReader::open(const string& path)
+{
+	close();
+	_error.clear();
+	_file = std::fopen(path.c_str(), "rb");
+	if(!_file)
+	{
+		_error = "Could not open " + path + ": " + std::strerror(errno);
+		return false;
+	}
+	char magic[sizeof(QueryRecorder::MAGIC)];
+	if(std::fread(magic, 1, sizeof(magic), _file) != sizeof(magic) || std::memcmp(magic, QueryRecorder::MAGIC, sizeof(magic)) != 0)
+	{
+		_error = path + " is not a query capture log.";
+		close();
+		return false;
+	}
+	_lastStart = 0;
+	return true;
+}
+
+/**
+ * Reads one varint.
+ * @param value Receives the value.
+ * @param end Set when the file ended before the first byte.
+ * @return If a whole varint was read or not.
+ */
+bool QueryLogReader::readVarint(uint64_t& value, bool& end)
+{
+	value = 0;
+	end = false;
+	for(unsigned shift = 0; shift < 64; shift += 7)
+	{
+		int c = std::fgetc(_file);
+		if(c == EOF)
+		{
+			end = shift == 0;
+			return false;
+		}
+		value |= uint64_t(c & 0x7F) << shift;
+		if(!(c & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Reads the next record.
+ * @param query Receives the record.
+ * @return If a record was read. false at the end of the log, or with getError() set when the log is damaged.
+ */
+bool QueryLogReader::next(RecordedQuery& query)
+{
+	if(!_file)
+	{
+		return false;
+	}
+	uint64_t delta, length;
+	bool end;
+	if(!readVarint(delta, end))
+	{
+		if(!end)
+		{
+			_error = "The capture log is truncated.";
+		}
+		return false;
+	}
+	if(!readVarint(query.connectionId, end) || !readVarint(query.duration, end) || !readVarint(length, end))
+	{
+		_error = "The capture log is truncated.";
+		return false;
+	}
+	_lastStart += static_cast<uint64_t>(static_cast<int64_t>(delta >> 1) ^ -static_cast<int64_t>(delta & 1));
+	query.start = _lastStart;
+	query.ok = length & 1;
+	query.sql.resize(static_cast<size_t>(length >> 1));
+	if(!query.sql.empty() && std::fread(&query.sql[0], 1, query.sql.size(), _file) != query.sql.size())
+	{
+		_error = "The capture log is truncated.";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Closes the log.
+ */
+void QueryLogReader::close()
+{
+	if(_file)
+	{
+		std::fclose(_file);
+		_file = nullptr;
+	}
+}
+
+/**
+ * Basic Destructor
+ */
+QueryLogReader::~QueryLogReader()
+{
+	close();
+}
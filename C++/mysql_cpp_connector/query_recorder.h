@@ -0,0 +1,98 @@
+/**
+ *
+ * @file query_recorder.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Compact binary capture of every query run through a set of Connectors, and a reader for it
+ */
+
+#ifndef QUERY_RECORDER_H
+#define QUERY_RECORDER_H
+
+#include <chrono> /**Library needed to use std::chrono*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <cstdio> /**Library needed to use std::FILE*/
+#include <mutex> /**Library needed to use std::mutex*/
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+/**
+ * One query read back from a capture log.
+ */
+struct RecordedQuery
+{
+	uint64_t start = 0; /**<When the query started, in nanoseconds since the log was opened.*/
+	uint64_t duration = 0; /**<How long it took, in nanoseconds.*/
+	uint64_t connectionId = 0; /**<Server thread id of the connection that ran it.*/
+	bool ok = false; /**<If it succeeded.*/
+	string sql; /**<Statement text.*/
+};
+
+/**
+ * Thread-safe writer of a query capture log shared by any number of Connectors (see Connector::setRecorder). Every
+ * statement sent through query(), store(), stream(), queryColumnar() or queryAs() (and what is built on them) is appended with
+ * its start time, duration, server connection id and outcome. Records are kept small: a magic header, then per query
+ * a zigzag varint start delta, varints for connection id, duration and length (with the outcome in its low bit) and
+ * the raw statement bytes. They are gathered in memory and written out in blocks, so recording costs a mutex and a
+ * memcpy per query.
+ */
+class QueryRecorder
+{
+	public:
+	using clock = std::chrono::steady_clock;
+	static const size_t BUFFER_BYTES = 64 * 1024; /**<Bytes gathered before they are written to the file.*/
+	static const char MAGIC[8]; /**<First bytes of every capture log.*/
+
+	private:
+	std::mutex _mutex; /**<Guards everything below.*/
+	std::FILE* _file = nullptr; /**<Log being written.*/
+	string _buffer; /**<Records not written yet.*/
+	clock::time_point _origin; /**<When the log was opened, the zero of every start time.*/
+	int64_t _lastStart = 0; /**<Start of the previous record, the base of the next delta.*/
+	uint64_t _records = 0; /**<Records appended.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	bool writeBuffer();
+
+	public:
+	QueryRecorder() = default;
+	QueryRecorder(const QueryRecorder& recorder) = delete;
+	QueryRecorder& operator=(const QueryRecorder& rhs) = delete;
+	bool open(const string& path);
+	void record(uint64_t connectionId, clock::time_point start, clock::time_point end, string_view sql, bool ok);
+	bool flush();
+	bool close();
+	bool isOpen();
+	uint64_t getNumRecords();
+	string getError();
+	~QueryRecorder();
+};
+
+/**
+ * Reads a capture log written by QueryRecorder one record at a time.
+ */
+class QueryLogReader
+{
+	std::FILE* _file = nullptr; /**<Log being read.*/
+	uint64_t _lastStart = 0; /**<Start of the previous record.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	bool readVarint(uint64_t& value, bool& end);
+
+	public:
+	QueryLogReader() = default;
+	QueryLogReader(const QueryLogReader& reader) = delete;
+	QueryLogReader& operator=(const QueryLogReader& rhs) = delete;
+	bool open(const string& path);
+	bool next(RecordedQuery& query);
+	void close();
+	inline string getError() const {return _error;}
+	~QueryLogReader();
+};
+
+#endif // QUERY_RECORDER_H
@@ -0,0 +1,292 @@
+/**
+ *
+ * @file reactor.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector coroutine event loop source file
+ */
+
+#include "reactor.h"
+
+#include <cerrno> /**Library needed to use errno*/
+#include <cstring> /**Library needed to use std::strlen and std::strerror*/
+#include <sys/epoll.h> /**Header needed to use epoll*/
+#include <unistd.h> /**Header needed to use ::close*/
+
+/**
+ * Starts the query. If the client library can finish it without waiting on the socket the coroutine is not suspended at all.
+ * @return If the operation already completed or not.
+ */
+bool Reactor::QueryOperation::await_ready()
+{
+	_status = mysql_real_query_start(&_queryError, _con, _sql, std::strlen(_sql));
+	advance(-1);
+	return _stage == DONE;
+}
+
+/**
+ * Parks the awaiting coroutine until the socket is ready.
+ * @param waiter Coroutine awaiting the query.
+ */
+void Reactor::QueryOperation::await_suspend(std::coroutine_handle<> waiter)
+{
+	_waiter = waiter;
+	_reactor->_inFlight++;
+	_reactor->wait(this);
+}
+
+/**
+ * Builds the Result handed back to the awaiting coroutine.
+ * @return Result owning the buffered rows, or carrying the error the query failed with.
+ */
+Result Reactor::QueryOperation::await_resume()
+{
+	Result result;
+	if(_failure)
+	{
+		result.setError(_failure);
+	}
+	else if(_queryError)
+	{
+		result.setError(mysql_error(_con));
+	}
+	else
+	{
+		result.load(_con, _res);
+	}
+	return result;
+}
+
+/**
+ * Moves the state machine forward. Continues the current step with the socket events that fired, then starts
+ * the next step for as long as the client library completes steps without needing to wait.
+ * @param ready MYSQL_WAIT_* events that fired, or -1 right after the first step was started.
+ */
+void Reactor::QueryOperation::advance(int ready)
+{
+	if(ready >= 0)
+	{
+		if(_stage == SENDING)
+		{
+			_status = mysql_real_query_cont(&_queryError, _con, ready);
+		}
+		else
+		{
+			_status = mysql_store_result_cont(&_res, _con, ready);
+		}
+	}
+
+	while(_status == 0 && _stage != DONE)
+	{
+		if(_stage == SENDING && !_queryError)
+		{
+			_stage = STORING;
+			_status = mysql_store_result_start(&_res, _con);
+		}
+		else
+		{
+			_stage = DONE;
+		}
+	}
+}
+
+/**
+ * Creates the epoll instance.
+ * @return If the event loop is ready to use or not.
+ */
+bool Reactor::open()
+{
+	close();
+	_error.clear();
+	_epoll = epoll_create1(EPOLL_CLOEXEC);
+	if(_epoll < 0)
+	{
+		_error = std::strerror(errno);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Switches a connected Connector to non-blocking operation. Must be called once per connection before it is used with query().
+ * @param con Connector to drive from this event loop.
+ * @return If the connection can be used non-blocking or not.
+ */
+bool Reactor::attach(Connector& con)
+{
+	if(mysql_options(con.getMYSQL_Ptr(), MYSQL_OPT_NONBLOCK, 0))
+	{
+		_error = "Could not enable non-blocking mode.";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Watches the socket of an operation for the events its last wait status asked for, plus its timeout if any.
+ * @param op Operation waiting on its connection.
+ */
+void Reactor::wait(QueryOperation* op)
+{
+	epoll_event event{};
+	event.events = EPOLLONESHOT;
+	if(op->_status & MYSQL_WAIT_READ)
+	{
+		event.events |= EPOLLIN;
+	}
+	if(op->_status & MYSQL_WAIT_WRITE)
+	{
+		event.events |= EPOLLOUT;
+	}
+	if(op->_status & MYSQL_WAIT_EXCEPT)
+	{
+		event.events |= EPOLLPRI;
+	}
+	event.data.ptr = op;
+
+	int fd = static_cast<int>(mysql_get_socket(op->_con));
+	if(epoll_ctl(_epoll, op->_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		// Nothing will ever wake this operation up, so fail it now rather than leaving the coroutine parked forever.
+		_error = std::strerror(errno);
+		op->_stage = QueryOperation::DONE;
+		op->_failure = "Could not watch the connection socket.";
+		finish(op);
+		return;
+	}
+	op->_registered = true;
+
+	if(op->_status & MYSQL_WAIT_TIMEOUT)
+	{
+		clock::time_point deadline = clock::now() + std::chrono::milliseconds(mysql_get_timeout_value_ms(op->_con));
+		op->_timer = _timers.emplace(deadline, op);
+		op->_timed = true;
+	}
+}
+
+/**
+ * Stops watching a completed operation and resumes its coroutine. The operation may be destroyed by the time this returns.
+ * @param op Operation that reached its DONE stage.
+ */
+void Reactor::finish(QueryOperation* op)
+{
+	if(op->_registered)
+	{
+		epoll_event event{};
+		epoll_ctl(_epoll, EPOLL_CTL_DEL, static_cast<int>(mysql_get_socket(op->_con)), &event);
+		op->_registered = false;
+	}
+	if(op->_timed)
+	{
+		_timers.erase(op->_timer);
+		op->_timed = false;
+	}
+	_inFlight--;
+	op->_waiter.resume();
+}
+
+/**
+ * Runs the event loop until no query is in flight anymore. Coroutines started before calling run() are driven to
+ * completion, as are any queries they start along the way.
+ * @return If the loop ran until every query completed or not.
+ */
+bool Reactor::run()
+{
+	epoll_event events[64];
+	while(_inFlight > 0)
+	{
+		int timeout = -1;
+		if(!_timers.empty())
+		{
+			std::chrono::milliseconds left = std::chrono::ceil<std::chrono::milliseconds>(_timers.begin()->first - clock::now());
+			timeout = left.count() > 0 ? static_cast<int>(left.count()) : 0;
+		}
+
+		int n = epoll_wait(_epoll, events, 64, timeout);
+		if(n < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			_error = std::strerror(errno);
+			return false;
+		}
+
+		for(int i = 0; i < n; i++)
+		{
+			QueryOperation* op = static_cast<QueryOperation*>(events[i].data.ptr);
+			int ready = 0;
+			if(events[i].events & EPOLLIN)
+			{
+				ready |= MYSQL_WAIT_READ;
+			}
+			if(events[i].events & EPOLLOUT)
+			{
+				ready |= MYSQL_WAIT_WRITE;
+			}
+			if(events[i].events & EPOLLPRI)
+			{
+				ready |= MYSQL_WAIT_EXCEPT;
+			}
+			if(events[i].events & (EPOLLERR | EPOLLHUP))
+			{
+				// Let the client library run into the error itself so it reports it properly.
+				ready |= op->_status & (MYSQL_WAIT_READ | MYSQL_WAIT_WRITE);
+			}
+			if(op->_timed)
+			{
+				_timers.erase(op->_timer);
+				op->_timed = false;
+			}
+			op->advance(ready);
+			if(op->_stage == QueryOperation::DONE)
+			{
+				finish(op);
+			}
+			else
+			{
+				wait(op);
+			}
+		}
+
+		clock::time_point now = clock::now();
+		while(!_timers.empty() && _timers.begin()->first <= now)
+		{
+			QueryOperation* op = _timers.begin()->second;
+			_timers.erase(_timers.begin());
+			op->_timed = false;
+			op->advance(MYSQL_WAIT_TIMEOUT);
+			if(op->_stage == QueryOperation::DONE)
+			{
+				finish(op);
+			}
+			else
+			{
+				wait(op);
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Closes the epoll instance. Must not be called while queries are in flight.
+ */
+void Reactor::close()
+{
+	if(_epoll >= 0)
+	{
+		::close(_epoll);
+		_epoll = -1;
+	}
+	_timers.clear();
+}
+
+/**
+ * Basic Destructor
+ */
+Reactor::~Reactor()
+{
+	close();
+}
@@ -0,0 +1,134 @@
+/**
+ *
+ * @file reactor.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief C++20 coroutine support for non-blocking queries driven by an epoll event loop
+ */
+
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+// The _start/_cont non-blocking API and mysql_get_socket only exist in MariaDB Connector/C.
+#if !defined(MYSQL_WAIT_READ)
+#error "reactor.h needs MariaDB Connector/C for its non-blocking API (mysql_real_query_start/_cont)."
+#endif
+#if __cplusplus < 202002L
+#error "reactor.h needs C++20 coroutines, compile with -std=c++20."
+#endif
+
+#include <chrono> /**Library needed to use std::chrono*/
+#include <coroutine> /**Library needed to use std::coroutine_handle*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <exception> /**Library needed to use std::terminate*/
+#include <map> /**Library needed to use std::multimap*/
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include "connector.h" /**Header needed to use Connector*/
+#include "result.h" /**Header needed to use Result*/
+
+/**
+ * Coroutine return type for fire-and-forget coroutines. The coroutine starts running as soon as it is called and
+ * frees itself when it finishes, so a caller can start as many as it likes and then hand control to Reactor::run().
+ */
+struct DetachedTask
+{
+	struct promise_type
+	{
+		inline DetachedTask get_return_object() {return DetachedTask();}
+		inline std::suspend_never initial_suspend() noexcept {return std::suspend_never();}
+		inline std::suspend_never final_suspend() noexcept {return std::suspend_never();}
+		inline void return_void() {}
+		inline void unhandled_exception() {std::terminate();}
+	};
+};
+
+/**
+ * Single threaded event loop that multiplexes any number of in-flight queries over epoll.
+ * Each query runs through the MariaDB non-blocking state machine (mysql_real_query_start/_cont followed by
+ * mysql_store_result_start/_cont); whenever the client library would block, the awaiting coroutine is suspended
+ * and the connection socket is watched until it is ready. One thread can therefore keep hundreds of queries in
+ * flight, one per connection.
+ *
+ * Connections are opened with the usual blocking Connector::connect and then handed to attach() once.
+ * A connection can only carry one query at a time.
+ *
+ *     DetachedTask handle(Reactor& reactor, Connector& con)
+ *     {
+ *         Result result = co_await reactor.query(con, "SELECT ...");
+ *     }
+ */
+class Reactor
+{
+	public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * Awaitable for one query. Returned by Reactor::query and resumed with the Result once the rows are buffered.
+	 */
+	class QueryOperation
+	{
+		friend class Reactor;
+
+		/**
+		 * Step of the non-blocking state machine the operation is in.
+		 */
+		enum Stage
+		{
+			SENDING, /**<mysql_real_query_start/_cont is running.*/
+			STORING, /**<mysql_store_result_start/_cont is running.*/
+			DONE /**<The result set is buffered or the query failed.*/
+		};
+
+		Reactor* _reactor = nullptr; /**<Event loop driving the operation.*/
+		MYSQL* _con = nullptr; /**<Connection the query runs on.*/
+		const char* _sql = nullptr; /**<Query text, must stay alive until the operation completes.*/
+		Stage _stage = SENDING; /**<Current step of the state machine.*/
+		int _status = 0; /**<Last wait status returned by the client library.*/
+		int _queryError = 0; /**<Return value of mysql_real_query.*/
+		MYSQL_RES* _res = nullptr; /**<Return value of mysql_store_result.*/
+		const char* _failure = nullptr; /**<Set when the event loop itself could not drive the operation.*/
+		bool _registered = false; /**<Boolean that stores if the socket is registered with epoll*/
+		std::multimap<clock::time_point, QueryOperation*>::iterator _timer; /**<Pending timeout, valid when _timed is set.*/
+		bool _timed = false; /**<Boolean that stores if a timeout is pending*/
+		std::coroutine_handle<> _waiter; /**<Coroutine to resume on completion.*/
+
+		void advance(int ready);
+
+		public:
+		QueryOperation(Reactor* reactor, MYSQL* con, const char* sql) : _reactor(reactor), _con(con), _sql(sql) {}
+		QueryOperation(const QueryOperation& op) = delete;
+		QueryOperation& operator=(const QueryOperation& rhs) = delete;
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> waiter);
+		Result await_resume();
+	};
+
+	private:
+	int _epoll = -1; /**<epoll instance watching connection sockets.*/
+	size_t _inFlight = 0; /**<Number of suspended operations.*/
+	std::multimap<clock::time_point, QueryOperation*> _timers; /**<Operations waiting on a client library timeout, by deadline.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	void wait(QueryOperation* op);
+	void finish(QueryOperation* op);
+
+	public:
+	Reactor() = default;
+	Reactor(const Reactor& reactor) = delete;
+	Reactor& operator=(const Reactor& rhs) = delete;
+	bool open();
+	bool attach(Connector& con);
+	inline QueryOperation query(Connector& con, const char* sql) {return QueryOperation(this, con.getMYSQL_Ptr(), sql);}
+	bool run();
+	void close();
+	inline size_t getNumInFlight() const {return _inFlight;}
+	inline string getError() const {return _error;}
+	~Reactor();
+};
+
+#endif // REACTOR_H
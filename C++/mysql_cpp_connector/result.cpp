@@ -0,0 +1,113 @@
+/**
+ *
+ * @file result.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector buffered result source file
+ */
+
+#include "result.h"
+
+#include <utility> /**Library needed to use std::exchange*/
+
+/**
+ * Move Constructor
+ * @param result Result whose result set is taken over.
+ */
+Result::Result(Result&& result) noexcept :
+	_res{std::move(result._res)},
+	_fields{std::exchange(result._fields, nullptr)},
+	_num_fields{std::exchange(result._num_fields, 0)},
+	_rows{std::move(result._rows)},
+	_affectedRows{std::exchange(result._affectedRows, 0)},
+	_definitionStatement{std::exchange(result._definitionStatement, false)},
+	_error{std::move(result._error)}
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs Result whose result set is taken over.
+ * @return The current object after the move has been complete.
+ */
+Result& Result::operator=(Result&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		clear();
+		_res = std::move(rhs._res);
+		_fields = std::exchange(rhs._fields, nullptr);
+		_num_fields = std::exchange(rhs._num_fields, 0);
+		_rows = std::move(rhs._rows);
+		_affectedRows = std::exchange(rhs._affectedRows, 0);
+		_definitionStatement = std::exchange(rhs._definitionStatement, false);
+		_error = std::move(rhs._error);
+	}
+	return *this;
+}
+
+/**
+ * Buffers the result of the query last sent on a connection and indexes its rows.
+ * @param con Connection that has just had a query sent on it.
+ * @return If the result was retrieved or not. Statements without a result set succeed with isDefinitionStatement() set.
+ */
+bool Result::load(MYSQL* con)
+{
+	return load(con, mysql_store_result(con));
+}
+
+/**
+ * Takes ownership of a result set that has already been buffered, for example by mysql_store_result_start, and indexes its rows.
+ * @param con Connection the result set was read from.
+ * @param res Buffered result set, or nullptr when the statement produced none or the transfer failed.
+ * @return If the result was retrieved or not. Statements without a result set succeed with isDefinitionStatement() set.
+ */
+bool Result::load(MYSQL* con, MYSQL_RES* res)
+{
+	clear();
+	_error.clear();
+	_res.reset(res);
+	if(!_res)
+	{
+		if(mysql_field_count(con) != 0)
+		{
+			_error = mysql_error(con);
+			return false;
+		}
+		_definitionStatement = true;
+		_affectedRows = mysql_affected_rows(con);
+		return true;
+	}
+
+	_num_fields = mysql_num_fields(_res.get());
+	_fields = mysql_fetch_fields(_res.get());
+	size_t num_rows = static_cast<size_t>(mysql_num_rows(_res.get()));
+	_rows.reserve(num_rows);
+	MYSQL_ROW row;
+	while((row = mysql_fetch_row(_res.get())))
+	{
+		_rows.push_back(row);
+	}
+	return true;
+}
+
+/**
+ * Frees the result set. Rows previously handed out are no longer valid afterwards.
+ */
+void Result::clear()
+{
+	_res.reset();
+	_fields = nullptr;
+	_num_fields = 0;
+	_rows.clear();
+	_affectedRows = 0;
+	_definitionStatement = false;
+}
+
+/**
+ * Basic Destructor
+ */
+Result::~Result()
+{
+	clear();
+}
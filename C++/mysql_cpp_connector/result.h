@@ -0,0 +1,98 @@
+/**
+ *
+ * @file result.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Owning handle over a buffered MySQL result set with zero-copy row views
+ */
+
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstddef> /**Library needed to use std::size_t and std::ptrdiff_t*/
+#include <iterator> /**Library needed to use std::forward_iterator_tag*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "handles.h" /**Header needed to use ResultHandle*/
+#include "row.h" /**Header needed to use Row*/
+
+/**
+ * Keeps the MYSQL_RES from mysql_store_result alive and exposes its rows as Row views.
+ * Cell bytes are never copied: every Row points into the buffer the client library already holds.
+ * The only extra memory is one pointer per row, gathered once when the result is loaded, which makes rows randomly
+ * accessible and lets a loaded Result be read from several threads at once. Cell lengths are worked out from the
+ * row itself when a cell is read (see Row).
+ */
+class Result
+{
+	ResultHandle _res; /**<Buffered MySQL Results C structure owned by this object.*/
+	MYSQL_FIELD* _fields = nullptr; /**<Field descriptions owned by _res.*/
+	unsigned int _num_fields = 0; /**<Used to store number of fields retrieved*/
+	vector<MYSQL_ROW> _rows; /**<Every row of _res in order.*/
+	my_ulonglong _affectedRows = 0; /**<Used to store affected rows when no data can be retrieved*/
+	bool _definitionStatement = false; /**<Boolean that stores if the statement produced no result set*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	public:
+	/**
+	 * Iterator over the rows of a Result, usable in range-based for loops.
+	 */
+	class iterator
+	{
+		const Result* _result = nullptr; /**<Result being walked.*/
+		size_t _index = 0; /**<Index of the current row.*/
+
+		public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Row;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Row;
+
+		iterator() = default;
+		iterator(const Result* result, size_t index) : _result(result), _index(index) {}
+		inline Row operator*() const {return (*_result)[_index];}
+		inline iterator& operator++() {++_index; return *this;}
+		inline iterator operator++(int) {iterator tmp = *this; ++_index; return tmp;}
+		inline bool operator==(const iterator& rhs) const {return _index == rhs._index && _result == rhs._result;}
+		inline bool operator!=(const iterator& rhs) const {return !(*this == rhs);}
+	};
+
+	Result() = default;
+	Result(const Result& result) = delete;
+	Result& operator=(const Result& rhs) = delete;
+	Result(Result&& result) noexcept;
+	Result& operator=(Result&& rhs) noexcept;
+	bool load(MYSQL* con);
+	bool load(MYSQL* con, MYSQL_RES* res);
+	void clear();
+	inline Row operator[](size_t i) const {return Row(_rows[i], _num_fields);}
+	inline string_view cell(size_t row, unsigned int field) const {return (*this)[row][field];}
+	inline bool isNull(size_t row, unsigned int field) const {return _rows[row][field] == nullptr;}
+	inline iterator begin() const {return iterator(this, 0);}
+	inline iterator end() const {return iterator(this, _rows.size());}
+	inline size_t size() const {return _rows.size();}
+	inline bool empty() const {return _rows.empty();}
+	inline size_t getNumRows() const {return _rows.size();}
+	inline int getNumFields() const {return _num_fields;}
+	inline string_view getFieldName(unsigned int i) const {return _fields[i].name;}
+	inline const MYSQL_FIELD* getFields() const {return _fields;}
+	inline my_ulonglong getNumAffectedRows() const {return _affectedRows;}
+	inline bool isDefinitionStatement() const {return _definitionStatement;}
+	inline string getError() const {return _error;}
+	inline void setError(const string& error) {_error = error;}
+	inline MYSQL_RES* getMYSQL_RES_Ptr() const {return _res.get();}
+	~Result();
+};
+
+#endif // RESULT_H
@@ -0,0 +1,468 @@
+/**
+ *
+ * @file router.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector read/write router source file
+ */
+
+#include "router.h"
+
+#include "sql_lexer.h" /**Header needed to use Lexer*/
+
+#include <algorithm> /**Library needed to use std::search*/
+#include <cctype> /**Library needed to use std::isspace and std::tolower*/
+#include <cstring> /**Library needed to use std::strlen*/
+#include <utility> /**Library needed to use std::exchange*/
+
+namespace
+{
+	using sql::Lexer;
+	using sql::Token;
+	using sql::isOneOf;
+
+	/**
+	 * Statements that only read.
+	 */
+	const string_view READ_KEYWORDS[] = {"select", "show", "explain", "describe", "desc", "with"};
+
+	/**
+	 * Statements that change the session, which then has to stay on the same connection.
+	 */
+	const string_view SESSION_KEYWORDS[] = {"set", "use", "lock", "unlock", "prepare", "execute", "deallocate", "handler"};
+
+	/**
+	 * Functions whose result depends on the connection or the primary, so a read calling them stays there.
+	 */
+	const string_view PRIMARY_FUNCTIONS[] = {"last_insert_id", "found_rows", "row_count", "get_lock", "release_lock",
+	                                        "release_all_locks", "is_free_lock", "is_used_lock", "master_pos_wait",
+	                                        "source_pos_wait", "wait_for_executed_gtid_set", "master_gtid_wait"};
+
+	/**
+	 * Checks if text contains word, ignoring case. word must be lower case.
+	 */
+	bool containsWord(string_view text, string_view word)
+	{
+		return std::search(text.begin(), text.end(), word.begin(), word.end(),
+		                   [](char a, char b) {return std::tolower(static_cast<unsigned char>(a)) == b;}) != text.end();
+	}
+}
+
+/**
+ * Opens the connections to the primary and every replica, each server in parallel.
+ * @param primary Parameters of the primary.
+ * @param replicas Parameters of each replica, may be empty.
+ * @param connectionsPerServer Size of the pool opened to each server.
+ * @param keepalive How long a connection may sit idle before it is pinged. Zero disables the keepalive threads.
+ * @return If every connection was opened or not. On failure no connection is left open.
+ */
+bool Router::open(const ConnectionOptions& primary, const vector<ConnectionOptions>& replicas, size_t connectionsPerServer,
+                  ConnectionPool::clock::duration keepalive)
+{
+	close();
+	_error.clear();
+	if(!_primary.open(primary, connectionsPerServer, keepalive))
+	{
+		_error = "Primary: " + _primary.getError();
+		return false;
+	}
+	for(size_t i = 0; i < replicas.size(); i++)
+	{
+		std::unique_ptr<ConnectionPool> pool(new ConnectionPool());
+		if(!pool->open(replicas[i], connectionsPerServer, keepalive))
+		{
+			_error = "Replica " + std::to_string(i) + ": " + pool->getError();
+			close();
+			return false;
+		}
+		_replicas.push_back(std::move(pool));
+	}
+	return true;
+}
+
+/**
+ * Closes every connection. All Sessions must have been reset or destroyed beforehand.
+ */
+void Router::close()
+{
+	_replicas.clear();
+	_primary.close();
+}
+
+/**
+ * Works out where a statement may run. Only the first statement of a multi statement query is looked at beyond
+ * noticing there are more, which sends the whole query to the primary.
+ * @param sql Statement text.
+ * @return Route of the statement.
+ */
+Router::Route Router::classify(string_view sql)
+{
+	// The lexer skips comments, so hints in the leading ones are picked out first.
+	bool hintPrimary = false, hintReplica = false;
+	size_t pos = 0;
+	while(true)
+	{
+		while(pos < sql.size() && std::isspace(static_cast<unsigned char>(sql[pos])))
+		{
+			pos++;
+		}
+		if(sql.compare(pos, 2, "/*") != 0)
+		{
+			break;
+		}
+		size_t end = sql.find("*/", pos + 2);
+		string_view comment = sql.substr(pos + 2, end == string_view::npos ? string_view::npos : end - pos - 2);
+		hintPrimary = hintPrimary || containsWord(comment, "route:primary");
+		hintReplica = hintReplica || containsWord(comment, "route:replica");
+		if(end == string_view::npos)
+		{
+			break;
+		}
+		pos = end + 2;
+	}
+
+	Lexer lexer(sql);
+	Token token;
+	bool found;
+	while((found = lexer.next(token)) && token.text == "(")
+	{
+	}
+	if(!found || !token.word)
+	{
+		return WRITE;
+	}
+	if(isOneOf(token.text, SESSION_KEYWORDS))
+	{
+		return SESSION_STATE;
+	}
+	if(isOneOf(token.text, {"create", "drop"}))
+	{
+		// Temporary tables only exist on the connection that made them.
+		return lexer.next(token) && isOneOf(token.text, {"temporary"}) ? SESSION_STATE : WRITE;
+	}
+	if(!isOneOf(token.text, READ_KEYWORDS))
+	{
+		return WRITE;
+	}
+
+	bool cte = isOneOf(token.text, {"with"});
+	Route route = READ;
+	string_view previous;
+	while(lexer.next(token))
+	{
+		if(token.text == ";")
+		{
+			if(lexer.next(token))
+			{
+				return WRITE;
+			}
+			break;
+		}
+		if(!token.word)
+		{
+			previous = string_view();
+			continue;
+		}
+		if((isOneOf(previous, {"for"}) && isOneOf(token.text, {"update", "share"})) || (isOneOf(previous, {"lock"}) && isOneOf(token.text, {"in"})) ||
+		   isOneOf(token.text, PRIMARY_FUNCTIONS) || (token.text[0] == '@' && token.text.compare(0, 2, "@@") != 0))
+		{
+			route = PRIMARY_READ;
+		}
+		else if(isOneOf(token.text, {"into"}))
+		{
+			// SELECT ... INTO @variable sets session state, INTO OUTFILE writes on the server.
+			return SESSION_STATE;
+		}
+		else if(cte && isOneOf(token.text, {"update", "delete"}))
+		{
+			return WRITE;
+		}
+		previous = token.text;
+	}
+	if(hintPrimary)
+	{
+		return PRIMARY_READ;
+	}
+	return hintReplica ? REPLICA_READ : route;
+}
+
+/**
+ * Borrows a replica connection according to the balance policy. Blocks until one is free.
+ * @return Handle on a replica connection, or an empty Handle once the Router is closed.
+ */
+ConnectionPool::Handle Router::acquireReplica()
+{
+	size_t count = _replicas.size();
+	size_t start = _next.fetch_add(1, std::memory_order_relaxed) % count;
+	if(_balance == LEAST_LOADED)
+	{
+		// Compares busy / size between replicas without dividing. Ties go to the round robin position.
+		size_t best = start, bestBusy = 0, bestSize = 1;
+		for(size_t i = 0; i < count; i++)
+		{
+			ConnectionPool& pool = *_replicas[(start + i) % count];
+			size_t size = pool.getSize();
+			size_t busy = size - pool.getNumAvailable();
+			if(i == 0 || busy * bestSize < bestBusy * size)
+			{
+				best = (start + i) % count;
+				bestBusy = busy;
+				bestSize = size;
+			}
+		}
+		return _replicas[best]->acquire();
+	}
+	for(size_t i = 0; i < count; i++)
+	{
+		ConnectionPool::Handle handle = _replicas[(start + i) % count]->tryAcquire();
+		if(handle)
+		{
+			return handle;
+		}
+	}
+	return _replicas[start]->acquire();
+}
+
+/**
+ * Basic Destructor
+ */
+Router::~Router()
+{
+	close();
+}
+
+/**
+ * Picks the connection a statement runs on. The connections of the previous statement are given back first, except
+ * the primary one while the Session is pinned or in a transaction.
+ * @param sql Statement text.
+ * @param route Receives the route of the statement.
+ * @return The connection, or nullptr with getError() set.
+ */
+Connector* Router::Session::route(string_view sql, Route& route)
+{
+	_error.clear();
+	_last = nullptr;
+	if(!_router)
+	{
+		_error = "The Session does not belong to a Router.";
+		return nullptr;
+	}
+	route = Router::classify(sql);
+	if(route == SESSION_STATE)
+	{
+		_pinned = true;
+	}
+	bool inTransaction = _primary && (_primary->getMYSQL_Ptr()->server_status & SERVER_STATUS_IN_TRANS);
+	bool recentWrite = _hasWritten && clock::now() - _lastWrite < _router->_readYourWrites;
+	bool toReplica = !_router->_replicas.empty() &&
+	                 (route == REPLICA_READ || (route == READ && !_pinned && !inTransaction && !recentWrite));
+
+	_replica.release();
+	if(toReplica)
+	{
+		if(!_pinned && !inTransaction)
+		{
+			_primary.release();
+		}
+		_replica = _router->acquireReplica();
+		if(!_replica)
+		{
+			_error = "The Router is closed.";
+			return nullptr;
+		}
+		_last = &*_replica;
+		return _last;
+	}
+	if(!_primary)
+	{
+		_primary = _router->_primary.acquire();
+		if(!_primary)
+		{
+			_error = "The Router is closed.";
+			return nullptr;
+		}
+	}
+	_last = &*_primary;
+	return _last;
+}
+
+/**
+ * Bookkeeping after a statement ran: starts the read-your-writes window after a write and takes over the error.
+ * @param route Route of the statement.
+ * @param ok If the statement succeeded.
+ */
+void Router::Session::finish(Route route, bool ok)
+{
+	if(route == WRITE)
+	{
+		_hasWritten = true;
+		_lastWrite = clock::now();
+	}
+	if(!ok)
+	{
+		_error = _last->getError();
+	}
+}
+
+/**
+ * Runs a statement on the primary or a replica, leaving its result in getConnector().
+ * @param query Statement to execute.
+ * @see Connector::query(const char* query)
+ * @return If query was successfully executed or not.
+ */
+bool Router::Session::query(const char* query)
+{
+	return this->query(query, static_cast<unsigned long>(std::strlen(query)));
+}
+
+/**
+ * Runs a statement of known length on the primary or a replica, leaving its result in getConnector().
+ * @param query Statement to execute. It does not need to be null terminated.
+ * @param length Length of query in bytes.
+ * @see Connector::query(const char* query, unsigned long length)
+ * @return If query was successfully executed or not.
+ */
+bool Router::Session::query(const char* query, unsigned long length)
+{
+	Route r;
+	Connector* con = route(string_view(query, length), r);
+	if(!con)
+	{
+		return false;
+	}
+	bool rval = con->query(query, length);
+	finish(r, rval);
+	return rval;
+}
+
+/**
+ * Runs a statement on the primary or a replica, handing its buffered result set over to a Result.
+ * @param query Statement to execute.
+ * @param result Result that takes ownership of the result set.
+ * @see Connector::store(const char* query, Result& result)
+ * @return If query was successfully executed or not.
+ */
+bool Router::Session::store(const char* query, Result& result)
+{
+	Route r;
+	Connector* con = route(query, r);
+	if(!con)
+	{
+		result.setError(_error);
+		return false;
+	}
+	bool rval = con->store(query, result);
+	finish(r, rval);
+	return rval;
+}
+
+/**
+ * Runs a statement on the primary or a replica and streams its rows through a Cursor. The Cursor has to be read to
+ * the end or closed before the next statement.
+ * @param query Statement to execute.
+ * @param cursor Cursor that will stream the rows of the result set.
+ * @see Connector::stream(const char* query, Cursor& cursor)
+ * @return If query was successfully executed or not.
+ */
+bool Router::Session::stream(const char* query, Cursor& cursor)
+{
+	Route r;
+	Connector* con = route(query, r);
+	if(!con)
+	{
+		return false;
+	}
+	bool rval = con->stream(query, cursor);
+	finish(r, rval);
+	return rval;
+}
+
+/**
+ * Runs a statement on the primary or a replica and decodes its result set into typed columns.
+ * @param query Statement to execute.
+ * @param result ColumnarResult that receives the decoded columns.
+ * @see Connector::queryColumnar(const char* query, ColumnarResult& result)
+ * @return If query was successfully executed and decoded or not.
+ */
+bool Router::Session::queryColumnar(const char* query, ColumnarResult& result)
+{
+	Route r;
+	Connector* con = route(query, r);
+	if(!con)
+	{
+		return false;
+	}
+	bool rval = con->queryColumnar(query, result);
+	finish(r, rval);
+	return rval;
+}
+
+/**
+ * Undoes the session state of the primary connection before it goes back to the pool. mysql_reset_connection rolls
+ * back, unlocks tables, drops temporary tables and prepared statements and clears user and session variables, then
+ * the database the pool was opened with is selected again. If either fails the connection is opened again with
+ * Connector::reconnect, which keeps what was set on it.
+ */
+void Router::Session::resetPrimary()
+{
+	Connector& con = *_primary;
+	const ConnectionOptions& options = _router->_primary.getOptions();
+	// The server forgets the prepared statements, so they are closed before the cache would hand them out again.
+	con.getStatementCache().clear();
+	MYSQL* mysql = con.getMYSQL_Ptr();
+	if(mysql_reset_connection(mysql) == 0 &&
+	   (options.db.empty() ? mysql->db == nullptr : mysql_select_db(mysql, options.db.c_str()) == 0))
+	{
+		return;
+	}
+	con.reconnect(options);
+}
+
+/**
+ * Gives every connection back and forgets the pinning and the read-your-writes window, for example at the end of a
+ * request. A primary connection that is pinned or still inside a transaction has its session state undone first (see
+ * resetPrimary()), so an unfinished transaction is rolled back instead of being handed to the next borrower.
+ */
+void Router::Session::reset()
+{
+	_replica.release();
+	if(_primary && (_pinned || (_primary->getMYSQL_Ptr()->server_status & SERVER_STATUS_IN_TRANS)))
+	{
+		resetPrimary();
+	}
+	_primary.release();
+	_last = nullptr;
+	_pinned = false;
+	_hasWritten = false;
+	_error.clear();
+}
+
+/**
+ * Move assignment operator. The connections held so far are given back as by reset().
+ * @param rhs Session whose Router and connections are taken over.
+ * @return The current object after the move has been complete.
+ */
+Router::Session& Router::Session::operator=(Session&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		reset();
+		_router = std::exchange(rhs._router, nullptr);
+		_primary = std::move(rhs._primary);
+		_replica = std::move(rhs._replica);
+		_last = std::exchange(rhs._last, nullptr);
+		_pinned = std::exchange(rhs._pinned, false);
+		_hasWritten = std::exchange(rhs._hasWritten, false);
+		_lastWrite = rhs._lastWrite;
+		_error = std::move(rhs._error);
+	}
+	return *this;
+}
+
+/**
+ * Basic Destructor. Gives the connections back as by reset().
+ */
+Router::Session::~Session()
+{
+	reset();
+}
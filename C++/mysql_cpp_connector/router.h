@@ -0,0 +1,143 @@
+/**
+ *
+ * @file router.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Read/write splitting over a primary and any number of replicas
+ */
+
+#ifndef ROUTER_H
+#define ROUTER_H
+
+#include <atomic> /**Library needed to use std::atomic*/
+#include <chrono> /**Library needed to use std::chrono*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <memory> /**Library needed to use std::unique_ptr*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "connection_pool.h" /**Header needed to use ConnectionPool*/
+
+/**
+ * Sends writes to a primary and reads to replicas. The Router owns one ConnectionPool per server and is shared by
+ * every thread; each thread (or request) runs its statements through a Session, which has the same query(), store(),
+ * stream() and queryColumnar() as a Connector and picks the server per statement:
+ *
+ *     - SELECT, SHOW, EXPLAIN and DESCRIBE go to a replica, round robin or to the one with the fewest connections
+ *       in use. Locking reads (FOR UPDATE, LOCK IN SHARE MODE), SELECT ... INTO and reads of user variables or
+ *       connection bound functions (LAST_INSERT_ID(), GET_LOCK()...) stay on the primary.
+ *     - Everything else goes to the primary. After a write, the Session keeps reading from the primary for the
+ *       read-your-writes window so it sees its own changes before the replicas have caught up.
+ *     - Statements changing session state (SET, USE, LOCK TABLES, PREPARE, temporary tables...) pin the Session to
+ *       one primary connection until it is reset or destroyed, and an open transaction keeps it there until it
+ *       ends. The session state, and a transaction left open, are undone before that connection goes back to the
+ *       pool.
+ *     - A leading comment holding route:primary or route:replica overrides all of that for a read. Writes always go
+ *       to the primary.
+ *
+ * With no replicas every statement goes to the primary.
+ */
+class Router
+{
+	public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * How reads are spread over the replicas.
+	 */
+	enum Balance
+	{
+		ROUND_ROBIN, /**<Each read goes to the next replica, skipping any without a free connection.*/
+		LEAST_LOADED /**<Each read goes to the replica with the smallest share of its connections in use.*/
+	};
+
+	/**
+	 * What a statement is, as far as routing goes.
+	 */
+	enum Route
+	{
+		READ, /**<Plain read, may go to a replica.*/
+		PRIMARY_READ, /**<Read that must see the primary (locking reads, connection bound functions, route:primary).*/
+		WRITE, /**<Change, runs on the primary and starts the read-your-writes window.*/
+		SESSION_STATE, /**<Changes the session, runs on the primary and pins the Session to that connection.*/
+		REPLICA_READ /**<Read sent to a replica whatever the Session state (route:replica).*/
+	};
+
+	/**
+	 * One caller's view of the Router. Results of a statement are read from the Session (or from getConnector())
+	 * until the next statement; a Cursor from stream() must be read to the end or closed before it. A Session is
+	 * not thread-safe, use one per thread.
+	 */
+	class Session
+	{
+		Router* _router = nullptr; /**<Router the connections are borrowed from.*/
+		ConnectionPool::Handle _primary; /**<Primary connection, kept while pinned, in a transaction or until the next statement.*/
+		ConnectionPool::Handle _replica; /**<Replica connection of the last read, kept until the next statement.*/
+		Connector* _last = nullptr; /**<Connection the last statement ran on.*/
+		bool _pinned = false; /**<Boolean that stores if session state ties the Session to its primary connection*/
+		bool _hasWritten = false; /**<Boolean that stores if _lastWrite is set*/
+		clock::time_point _lastWrite; /**<When the last write finished.*/
+		string _error; /**<String that stores any error messages that is encountered*/
+
+		Connector* route(string_view sql, Route& route);
+		void finish(Route route, bool ok);
+		void resetPrimary();
+
+		public:
+		Session() = default;
+		explicit Session(Router* router) : _router(router) {}
+		Session(const Session& session) = delete;
+		Session& operator=(const Session& rhs) = delete;
+		Session(Session&& session) noexcept = default;
+		Session& operator=(Session&& rhs) noexcept;
+		bool query(const char* query);
+		bool query(const char* query, unsigned long length);
+		bool store(const char* query, Result& result);
+		bool stream(const char* query, Cursor& cursor);
+		bool queryColumnar(const char* query, ColumnarResult& result);
+		void reset();
+		inline Connector* getConnector() const {return _last;}
+		inline bool isPinned() const {return _pinned;}
+		inline bool isOnPrimary() const {return _last && _primary && _last == &*_primary;}
+		inline string getError() const {return _error;}
+		~Session();
+	};
+
+	private:
+	ConnectionPool _primary; /**<Connections to the primary.*/
+	vector<std::unique_ptr<ConnectionPool> > _replicas; /**<Connections to each replica.*/
+	std::atomic<size_t> _next{0}; /**<Round robin position.*/
+	Balance _balance = ROUND_ROBIN; /**<How reads are spread over the replicas.*/
+	clock::duration _readYourWrites = std::chrono::seconds(1); /**<How long reads stay on the primary after a write.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	ConnectionPool::Handle acquireReplica();
+
+	public:
+	Router() = default;
+	Router(const Router& router) = delete;
+	Router& operator=(const Router& rhs) = delete;
+	bool open(const ConnectionOptions& primary, const vector<ConnectionOptions>& replicas, size_t connectionsPerServer,
+	          ConnectionPool::clock::duration keepalive = std::chrono::seconds(30));
+	void close();
+	inline Session session() {return Session(this);}
+	inline void setBalance(Balance balance) {_balance = balance;}
+	inline Balance getBalance() const {return _balance;}
+	inline void setReadYourWritesWindow(clock::duration window) {_readYourWrites = window;}
+	inline clock::duration getReadYourWritesWindow() const {return _readYourWrites;}
+	inline size_t getNumReplicas() const {return _replicas.size();}
+	inline ConnectionPool& getPrimaryPool() {return _primary;}
+	inline ConnectionPool& getReplicaPool(size_t index) {return *_replicas[index];}
+	inline string getError() const {return _error;}
+	static Route classify(string_view sql);
+	~Router();
+};
+
+#endif // ROUTER_H
@@ -0,0 +1,56 @@
+/**
+ *
+ * @file row.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Non-owning view of a single row held by the MySQL client library
+ */
+
+#ifndef ROW_H
+#define ROW_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+/**
+ * Lightweight view over a MYSQL_ROW and its cell lengths. Rows of an unbuffered result (Cursor) carry the lengths
+ * reported by mysql_fetch_lengths; rows of a buffered result (Result) carry none and work each length out from where
+ * the next cell starts, the same way mysql_fetch_lengths does for those.
+ * Cells are handed out as std::string_view straight into the client library buffer: no strlen, no copies.
+ * A Row is only valid for as long as the Result or Cursor it came from keeps that buffer alive.
+ */
+class Row
+{
+	MYSQL_ROW _row = nullptr; /**<MYSQL Row C Structure being viewed.*/
+	const unsigned long* _lengths = nullptr; /**<Byte length of every cell in the row, nullptr for a buffered row.*/
+	unsigned int _num_fields = 0; /**<Used to store number of fields in the row*/
+
+	public:
+	Row() = default;
+	Row(MYSQL_ROW row, const unsigned long* lengths, unsigned int num_fields) : _row(row), _lengths(lengths), _num_fields(num_fields) {}
+	Row(MYSQL_ROW row, unsigned int num_fields) : _row(row), _num_fields(num_fields) {}
+	inline string_view operator[](unsigned int i) const {return _row[i] ? string_view(_row[i], length(i)) : string_view();}
+	inline unsigned long length(unsigned int i) const
+	{
+		if(_lengths || !_row[i])
+		{
+			return _lengths ? _lengths[i] : 0;
+		}
+		// A buffered row stores every cell followed by a null character, plus one pointer past the last cell.
+		unsigned int next = i + 1;
+		while(!_row[next])
+		{
+			next++;
+		}
+		return static_cast<unsigned long>(_row[next] - _row[i] - 1);
+	}
+	inline bool isNull(unsigned int i) const {return _row[i] == nullptr;}
+	inline unsigned int size() const {return _num_fields;}
+	inline bool isValid() const {return _row != nullptr;}
+	inline MYSQL_ROW getMYSQL_ROW_Struct() const {return _row;}
+	inline const unsigned long* getLengths() const {return _lengths;}
+};
+
+#endif // ROW_H
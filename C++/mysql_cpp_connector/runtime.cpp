@@ -0,0 +1,201 @@
+/**
+ *
+ * @file runtime.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector client runtime source file
+ */
+
+#include "runtime.h"
+
+#include <mutex> /**Library needed to use std::mutex*/
+#include <utility> /**Library needed to use std::exchange*/
+
+/**
+ * Guards runtimeRefs, runtimeInitialized, runtimeExiting and the calls to mysql_library_init/mysql_library_end.
+ */
+static std::mutex runtimeMutex;
+
+/**
+ * Number of live references on the client library.
+ */
+static size_t runtimeRefs = 0;
+
+/**
+ * If mysql_library_init has succeeded and mysql_library_end has not run since.
+ */
+static bool runtimeInitialized = false;
+
+/**
+ * If the process has started destroying its static objects. From then on the last reference to go ends the library.
+ */
+static bool runtimeExiting = false;
+
+/**
+ * Constructed by the first acquire(), so it is destroyed before every static object constructed earlier, such as a
+ * namespace-scope ConnectionPool opened in main(). Those may still hold Connectors, so the library is only ended here
+ * when nothing references it; otherwise the last release() ends it.
+ */
+struct RuntimeExitGuard
+{
+	~RuntimeExitGuard()
+	{
+		std::lock_guard<std::mutex> lock(runtimeMutex);
+		runtimeExiting = true;
+		if(runtimeRefs == 0 && runtimeInitialized)
+		{
+			mysql_library_end();
+			runtimeInitialized = false;
+		}
+	}
+};
+
+/**
+ * Basic Constructor. Takes a reference on the client library, initializing it if this is the first one.
+ */
+ClientRuntime::ClientRuntime()
+{
+	acquire();
+}
+
+/**
+ * Copy Constructor
+ * @param runtime ClientRuntime to copy. A reference is only taken if runtime holds one.
+ */
+ClientRuntime::ClientRuntime(const ClientRuntime& runtime)
+{
+	if(runtime._held)
+	{
+		acquire();
+	}
+	else
+	{
+		_failed = runtime._failed;
+	}
+}
+
+/**
+ * Overloaded assignment operator
+ * @param rhs ClientRuntime to copy. A reference is only taken if rhs holds one.
+ * @return The current object after assignment has been complete.
+ */
+ClientRuntime& ClientRuntime::operator=(const ClientRuntime& rhs)
+{
+	if(this != &rhs && _held != rhs._held)
+	{
+		if(rhs._held)
+		{
+			acquire();
+		}
+		else
+		{
+			release();
+		}
+	}
+	_failed = rhs._failed;
+	return *this;
+}
+
+/**
+ * Move Constructor
+ * @param runtime ClientRuntime whose reference is taken over.
+ */
+ClientRuntime::ClientRuntime(ClientRuntime&& runtime) noexcept :
+	_held{std::exchange(runtime._held, false)},
+	_failed{runtime._failed}
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs ClientRuntime whose reference is taken over.
+ * @return The current object after the move has been complete.
+ */
+ClientRuntime& ClientRuntime::operator=(ClientRuntime&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		release();
+		_held = std::exchange(rhs._held, false);
+		_failed = rhs._failed;
+	}
+	return *this;
+}
+
+/**
+ * Takes a reference on the client library, initializing it if it is not yet.
+ */
+void ClientRuntime::acquire()
+{
+	std::lock_guard<std::mutex> lock(runtimeMutex);
+	if(!runtimeInitialized)
+	{
+		if(mysql_library_init(0,nullptr,nullptr))
+		{
+			_failed = true;
+			return;
+		}
+		runtimeInitialized = true;
+		static RuntimeExitGuard guard;
+	}
+	runtimeRefs++;
+	_held = true;
+	_failed = false;
+}
+
+/**
+ * Drops the reference held by this object. Before the process exits the library stays initialized even when this was
+ * the last reference, so a loop creating and destroying Connectors does not initialize and end it every time; once
+ * the process is exiting the last reference ends it.
+ */
+void ClientRuntime::release()
+{
+	if(!_held)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(runtimeMutex);
+	_held = false;
+	if(--runtimeRefs == 0 && runtimeExiting && runtimeInitialized)
+	{
+		mysql_library_end();
+		runtimeInitialized = false;
+	}
+}
+
+/**
+ * Counts the live references on the client library.
+ * @return Number of ClientRuntime objects holding the library.
+ */
+size_t ClientRuntime::getNumReferences()
+{
+	std::lock_guard<std::mutex> lock(runtimeMutex);
+	return runtimeRefs;
+}
+
+/**
+ * Basic Destructor
+ */
+ClientRuntime::~ClientRuntime()
+{
+	release();
+}
+
+/**
+ * Basic Constructor. Initializes the client library for the calling thread.
+ */
+ThreadScope::ThreadScope()
+{
+	_initialized = _runtime.isInitialized() && mysql_thread_init() == 0;
+}
+
+/**
+ * Basic Destructor. Releases the thread-specific memory of the client library for the calling thread.
+ */
+ThreadScope::~ThreadScope()
+{
+	if(_initialized)
+	{
+		mysql_thread_end();
+	}
+}
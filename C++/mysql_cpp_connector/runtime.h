@@ -0,0 +1,63 @@
+/**
+ *
+ * @file runtime.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Process-wide MySQL client library lifetime and per-thread initialization
+ */
+
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstddef> /**Library needed to use std::size_t*/
+
+/**
+ * Reference to the process-wide MySQL client library. The first ClientRuntime calls mysql_library_init under a mutex
+ * and the library then stays initialized while the program runs, even when no reference is left. Once the process
+ * exits, mysql_library_end runs as soon as the last reference is gone, so static Connectors, pools and executors are
+ * closed before it. Any number of Connectors can come and go on any number of threads without ending the library
+ * under the feet of the others, and only the very first one pays for initializing it.
+ *
+ * Every Connector holds one; getNumReferences() tells how many are alive.
+ */
+class ClientRuntime
+{
+	bool _held = false; /**<Boolean that stores if this object holds a reference on the library*/
+	bool _failed = false; /**<Boolean that stores if mysql_library_init failed*/
+
+	void acquire();
+
+	public:
+	ClientRuntime();
+	ClientRuntime(const ClientRuntime& runtime);
+	ClientRuntime& operator=(const ClientRuntime& rhs);
+	ClientRuntime(ClientRuntime&& runtime) noexcept;
+	ClientRuntime& operator=(ClientRuntime&& rhs) noexcept;
+	void release();
+	inline bool isInitialized() const {return _held;}
+	inline bool hasFailed() const {return _failed;}
+	static size_t getNumReferences();
+	~ClientRuntime();
+};
+
+/**
+ * Initializes the client library for the current thread and cleans up after it when destroyed.
+ * Create one at the top of every thread (other than the one that made the first Connector) that talks to MySQL:
+ * without it, thread-specific memory of the client library leaks every time such a thread exits.
+ */
+class ThreadScope
+{
+	ClientRuntime _runtime; /**<Keeps the library alive for as long as the thread uses it.*/
+	bool _initialized = false; /**<Boolean that stores if mysql_thread_init succeeded*/
+
+	public:
+	ThreadScope();
+	ThreadScope(const ThreadScope& scope) = delete;
+	ThreadScope& operator=(const ThreadScope& rhs) = delete;
+	inline bool isInitialized() const {return _initialized;}
+	~ThreadScope();
+};
+
+#endif // RUNTIME_H
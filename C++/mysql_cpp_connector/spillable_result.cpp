@@ -0,0 +1,437 @@
+/**
+ *
+ * @file spillable_result.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector spillable result source file
+ */
+
+#include "spillable_result.h"
+
+#include <algorithm> /**Library needed to use std::upper_bound*/
+#include <cstdlib> /**Library needed to use std::getenv*/
+#include <cstring> /**Library needed to use std::memcpy and std::strerror*/
+#include <cerrno> /**Library needed to use errno*/
+#include <utility> /**Library needed to use std::exchange and std::move*/
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPILLABLE_RESULT_POSIX 1
+#include <sys/mman.h> /**POSIX header needed to use mmap and munmap*/
+#include <unistd.h> /**POSIX header needed to use write, close and unlink*/
+#endif
+
+/**
+ * If chunks can be moved to a temp file. Without it the spill threshold is never checked.
+ */
+#if defined(SPILLABLE_RESULT_POSIX)
+static const bool CAN_SPILL = true;
+#else
+static const bool CAN_SPILL = false;
+#endif
+
+/**
+ * Rounds a byte count up to a multiple of 8 so every block stays aligned for uint64_t reads.
+ */
+static inline size_t pad8(size_t bytes)
+{
+	return (bytes + 7) & ~size_t(7);
+}
+
+/**
+ * Basic Constructor
+ * @param spillThreshold Bytes held in memory before the result spills to disk.
+ * @param spillDirectory Directory the temp file is created in, empty for $TMPDIR or /tmp.
+ */
+SpillableResult::SpillableResult(size_t spillThreshold, const string& spillDirectory) :
+	_spillThreshold(spillThreshold),
+	_spillDirectory(spillDirectory)
+{
+}
+
+/**
+ * Move Constructor
+ * @param result SpillableResult whose rows and temp file are taken over. It is left empty.
+ */
+SpillableResult::SpillableResult(SpillableResult&& result) noexcept :
+	_fieldNames(std::move(result._fieldNames)),
+	_num_fields(std::exchange(result._num_fields, 0)),
+	_num_rows(std::exchange(result._num_rows, 0)),
+	_chunks(std::move(result._chunks)),
+	_chunkFirstRows(std::move(result._chunkFirstRows)),
+	_memoryChunks(std::move(result._memoryChunks)),
+	_builders(std::move(result._builders)),
+	_builderBytes(std::exchange(result._builderBytes, 0)),
+	_memoryBytes(std::exchange(result._memoryBytes, 0)),
+	_spillThreshold(result._spillThreshold),
+	_spillDirectory(result._spillDirectory),
+	_fd(std::exchange(result._fd, -1)),
+	_fileBytes(std::exchange(result._fileBytes, 0)),
+	_map(std::exchange(result._map, nullptr)),
+	_error(std::move(result._error))
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs SpillableResult whose rows and temp file are taken over. It is left empty.
+ * @return The current object after the move has been complete.
+ */
+SpillableResult& SpillableResult::operator=(SpillableResult&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		clear();
+		_fieldNames = std::move(rhs._fieldNames);
+		_num_fields = std::exchange(rhs._num_fields, 0);
+		_num_rows = std::exchange(rhs._num_rows, 0);
+		_chunks = std::move(rhs._chunks);
+		_chunkFirstRows = std::move(rhs._chunkFirstRows);
+		_memoryChunks = std::move(rhs._memoryChunks);
+		_builders = std::move(rhs._builders);
+		_builderBytes = std::exchange(rhs._builderBytes, 0);
+		_memoryBytes = std::exchange(rhs._memoryBytes, 0);
+		_spillThreshold = rhs._spillThreshold;
+		_spillDirectory = rhs._spillDirectory;
+		_fd = std::exchange(rhs._fd, -1);
+		_fileBytes = std::exchange(rhs._fileBytes, 0);
+		_map = std::exchange(rhs._map, nullptr);
+		_error = std::move(rhs._error);
+	}
+	return *this;
+}
+
+/**
+ * Reads every remaining row of an open Cursor. The Cursor is left exhausted and closed.
+ * @param cursor Cursor over the result set, as opened by Connector::stream. A Cursor that is not open loads an empty result.
+ * @return If every row was read (and spilled when needed) or not.
+ */
+bool SpillableResult::load(Cursor& cursor)
+{
+	clear();
+	if(!cursor.isOpen())
+	{
+		_error = cursor.getError();
+		return _error.empty();
+	}
+
+	_fieldNames = cursor.getFieldNames();
+	_num_fields = static_cast<unsigned int>(cursor.getNumFields());
+	_builders.resize(_num_fields);
+	size_t builderRows = 0;
+	while(cursor.next())
+	{
+		MYSQL_ROW row = cursor.getMYSQL_ROW_Struct();
+		const unsigned long* lengths = cursor.getLengths();
+		for(unsigned int i = 0; i < _num_fields; i++)
+		{
+			ColumnBuilder& column = _builders[i];
+			if(builderRows % 64 == 0)
+			{
+				column.nulls.push_back(0);
+			}
+			if(row[i])
+			{
+				column.bytes.insert(column.bytes.end(), row[i], row[i] + lengths[i]);
+				_builderBytes += lengths[i];
+			}
+			else
+			{
+				column.nulls.back() |= uint64_t(1) << (builderRows % 64);
+			}
+			column.ends.push_back(column.bytes.size());
+		}
+		_builderBytes += _num_fields * sizeof(uint64_t);
+		_num_rows++;
+		builderRows++;
+
+		if(builderRows == CHUNK_ROWS || _builderBytes >= CHUNK_BYTES || (CAN_SPILL && _fd == -1 && _memoryBytes + _builderBytes > _spillThreshold))
+		{
+			if(!flushChunk())
+			{
+				cursor.close();
+				clear();
+				return false;
+			}
+			builderRows = 0;
+		}
+	}
+	if(!cursor.getError().empty())
+	{
+		_error = cursor.getError();
+		clear();
+		return false;
+	}
+	if(!finish())
+	{
+		clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Releases every row, the temp file and its mapping.
+ */
+void SpillableResult::clear()
+{
+#if defined(SPILLABLE_RESULT_POSIX)
+	if(_map)
+	{
+		munmap(_map, _fileBytes);
+	}
+	if(_fd != -1)
+	{
+		::close(_fd);
+	}
+#endif
+	_map = nullptr;
+	_fd = -1;
+	_fileBytes = 0;
+	_fieldNames.clear();
+	_num_fields = 0;
+	_num_rows = 0;
+	_chunks.clear();
+	_chunkFirstRows.clear();
+	_memoryChunks.clear();
+	_builders.clear();
+	_builderBytes = 0;
+	_memoryBytes = 0;
+	_error.clear();
+}
+
+/**
+ * Serializes the chunk being built and either keeps it in memory or appends it to the temp file.
+ * Spills every chunk held in memory first when keeping this one would pass the threshold.
+ * @return If the chunk was stored or not.
+ */
+bool SpillableResult::flushChunk()
+{
+	Chunk chunk;
+	chunk.firstRow = _chunks.empty() ? 0 : _chunks.back().firstRow + _chunks.back().rows;
+	chunk.rows = _num_rows - chunk.firstRow;
+	if(chunk.rows == 0)
+	{
+		return true;
+	}
+
+	size_t words = (chunk.rows + 63) / 64;
+	size_t size = 0;
+	chunk.columns.resize(_num_fields);
+	for(unsigned int i = 0; i < _num_fields; i++)
+	{
+		chunk.columns[i] = size;
+		size += (chunk.rows + words) * sizeof(uint64_t) + pad8(_builders[i].bytes.size());
+	}
+	vector<char> block(size);
+	for(unsigned int i = 0; i < _num_fields; i++)
+	{
+		ColumnBuilder& column = _builders[i];
+		char* out = block.data() + chunk.columns[i];
+		std::memcpy(out, column.ends.data(), chunk.rows * sizeof(uint64_t));
+		std::memcpy(out + chunk.rows * sizeof(uint64_t), column.nulls.data(), words * sizeof(uint64_t));
+		if(!column.bytes.empty())
+		{
+			std::memcpy(out + (chunk.rows + words) * sizeof(uint64_t), column.bytes.data(), column.bytes.size());
+		}
+		column.ends.clear();
+		column.nulls.clear();
+		column.bytes.clear();
+	}
+	_builderBytes = 0;
+
+	if(CAN_SPILL && _fd == -1 && _memoryBytes + size > _spillThreshold && !spill())
+	{
+		return false;
+	}
+	if(_fd != -1)
+	{
+		chunk.spilled = true;
+		chunk.fileOffset = _fileBytes;
+		if(!writeAll(block.data(), size))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		chunk.memoryIndex = _memoryChunks.size();
+		_memoryChunks.push_back(std::move(block));
+		_memoryBytes += size;
+	}
+	_chunks.push_back(std::move(chunk));
+	return true;
+}
+
+/**
+ * Creates the temp file and moves every chunk held in memory into it. The file is unlinked right away so it
+ * disappears with the process even if it crashes. Does nothing where mkstemp and mmap are not available.
+ * @return If the chunks were written or not.
+ */
+bool SpillableResult::spill()
+{
+#if defined(SPILLABLE_RESULT_POSIX)
+	string directory = _spillDirectory;
+	if(directory.empty())
+	{
+		const char* tmp = std::getenv("TMPDIR");
+		directory = tmp && *tmp ? tmp : "/tmp";
+	}
+	string path = directory + "/connector-spill-XXXXXX";
+	_fd = mkstemp(&path[0]);
+	if(_fd == -1)
+	{
+		_error = "Could not create a spill file in " + directory + ": " + std::strerror(errno);
+		return false;
+	}
+	unlink(path.c_str());
+
+	for(Chunk& chunk : _chunks)
+	{
+		if(!chunk.spilled)
+		{
+			vector<char>& block = _memoryChunks[chunk.memoryIndex];
+			chunk.spilled = true;
+			chunk.fileOffset = _fileBytes;
+			if(!writeAll(block.data(), block.size()))
+			{
+				return false;
+			}
+		}
+	}
+	_memoryChunks.clear();
+	_memoryBytes = 0;
+#endif
+	return true;
+}
+
+/**
+ * Appends bytes to the temp file.
+ * @param data Bytes to write.
+ * @param length Number of bytes.
+ * @return If every byte was written or not.
+ */
+bool SpillableResult::writeAll(const char* data, size_t length)
+{
+#if defined(SPILLABLE_RESULT_POSIX)
+	size_t written = 0;
+	while(written < length)
+	{
+		ssize_t n = ::write(_fd, data + written, length - written);
+		if(n < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			_error = string("Could not write the spill file: ") + std::strerror(errno);
+			return false;
+		}
+		written += static_cast<size_t>(n);
+	}
+	_fileBytes += length;
+	return true;
+#else
+	(void)data;
+	(void)length;
+	_error = "Spilling is not supported on this platform.";
+	return false;
+#endif
+}
+
+/**
+ * Stores the last chunk, maps the temp file and points every chunk at its data.
+ * @return If the result is ready to be read or not.
+ */
+bool SpillableResult::finish()
+{
+	if(!flushChunk())
+	{
+		return false;
+	}
+#if defined(SPILLABLE_RESULT_POSIX)
+	if(_fd != -1 && _fileBytes)
+	{
+		void* map = mmap(nullptr, _fileBytes, PROT_READ, MAP_SHARED, _fd, 0);
+		if(map == MAP_FAILED)
+		{
+			_error = string("Could not map the spill file: ") + std::strerror(errno);
+			return false;
+		}
+		_map = static_cast<char*>(map);
+	}
+#endif
+	_chunkFirstRows.reserve(_chunks.size());
+	for(Chunk& chunk : _chunks)
+	{
+		chunk.data = chunk.spilled ? _map + chunk.fileOffset : _memoryChunks[chunk.memoryIndex].data();
+		_chunkFirstRows.push_back(chunk.firstRow);
+	}
+	_builders.clear();
+	_builders.shrink_to_fit();
+	return true;
+}
+
+/**
+ * Finds the chunk holding a row.
+ * @param row Row index.
+ * @return The chunk.
+ */
+const SpillableResult::Chunk& SpillableResult::chunkOf(size_t row) const
+{
+	size_t index = static_cast<size_t>(std::upper_bound(_chunkFirstRows.begin(), _chunkFirstRows.end(), row) - _chunkFirstRows.begin()) - 1;
+	return _chunks[index];
+}
+
+/**
+ * Finds the block of a column inside the chunk holding a row.
+ * @param row Row index.
+ * @param field Field index.
+ * @param index Receives the index of the row inside its chunk.
+ * @param rows Receives the number of rows in the chunk.
+ * @return Start of the column block.
+ */
+const char* SpillableResult::columnBlock(size_t row, unsigned int field, size_t& index, size_t& rows) const
+{
+	const Chunk& chunk = chunkOf(row);
+	index = row - chunk.firstRow;
+	rows = chunk.rows;
+	return chunk.data + chunk.columns[field];
+}
+
+/**
+ * Reads a cell. Reading a spilled cell faults its pages in from the temp file if they are not cached.
+ * @param row Row index.
+ * @param field Field index.
+ * @return View of the cell bytes, empty for NULL.
+ */
+string_view SpillableResult::cell(size_t row, unsigned int field) const
+{
+	size_t index, rows;
+	const char* block = columnBlock(row, field, index, rows);
+	const uint64_t* ends = reinterpret_cast<const uint64_t*>(block);
+	const char* bytes = block + (rows + (rows + 63) / 64) * sizeof(uint64_t);
+	uint64_t start = index ? ends[index - 1] : 0;
+	return string_view(bytes + start, static_cast<size_t>(ends[index] - start));
+}
+
+/**
+ * Checks if a cell is SQL NULL.
+ * @param row Row index.
+ * @param field Field index.
+ * @return If the cell is NULL or not.
+ */
+bool SpillableResult::isNull(size_t row, unsigned int field) const
+{
+	size_t index, rows;
+	const char* block = columnBlock(row, field, index, rows);
+	const uint64_t* nulls = reinterpret_cast<const uint64_t*>(block) + rows;
+	return (nulls[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+ * Basic Destructor
+ */
+SpillableResult::~SpillableResult()
+{
+	clear();
+}
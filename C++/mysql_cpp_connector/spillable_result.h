@@ -0,0 +1,162 @@
+/**
+ *
+ * @file spillable_result.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Result set that moves to a memory-mapped columnar temp file once it outgrows a memory budget
+ */
+
+#ifndef SPILLABLE_RESULT_H
+#define SPILLABLE_RESULT_H
+
+#include <cstddef> /**Library needed to use std::size_t and std::ptrdiff_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <iterator> /**Library needed to use std::forward_iterator_tag*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "cursor.h" /**Header needed to use Cursor*/
+
+/**
+ * Reads an unbuffered result set row by row into column-oriented chunks. Chunks stay in memory until their total size
+ * passes the spill threshold; from then on every chunk, including the ones already held, is written to an unlinked
+ * temp file which is memory-mapped once the last row has arrived. Reading a cell of a spilled chunk only faults in the
+ * pages it lives on, so a report far larger than memory is read at disk speed instead of getting the process killed.
+ *
+ * Rows are read the same way as from a Result: operator[] and range-based for loops hand out row views with
+ * operator[], isNull() and size(), and cell(row, field) and isNull(row, field) read single cells. Everything handed out
+ * stays valid until the SpillableResult is loaded again, cleared or destroyed.
+ *
+ * Spilling needs POSIX mkstemp and mmap. On other platforms the whole result is kept in memory.
+ */
+class SpillableResult
+{
+	/**
+	 * One chunk of consecutive rows. Each column is stored as one block: the end offset of every cell (uint64_t per
+	 * row), a NULL bitmap (one bit per row) and the packed cell bytes, padded to 8 bytes.
+	 */
+	struct Chunk
+	{
+		size_t firstRow = 0; /**<Index of the first row in the chunk.*/
+		size_t rows = 0; /**<Number of rows in the chunk.*/
+		uint64_t fileOffset = 0; /**<Where the chunk starts in the temp file, when spilled.*/
+		size_t memoryIndex = 0; /**<Index into _memoryChunks, when held in memory.*/
+		bool spilled = false; /**<If the chunk lives in the temp file.*/
+		vector<uint64_t> columns; /**<Offset of every column block from the start of the chunk.*/
+		const char* data = nullptr; /**<Start of the chunk once loading is done.*/
+	};
+
+	/**
+	 * Rows of one column gathered for the chunk being built.
+	 */
+	struct ColumnBuilder
+	{
+		vector<uint64_t> ends; /**<End offset of every cell in bytes.*/
+		vector<uint64_t> nulls; /**<Bitmap with bit r set when row r is NULL.*/
+		vector<char> bytes; /**<Packed cell bytes.*/
+	};
+
+	vector<string> _fieldNames; /**<Vector of std::string used to store field names retrieved.*/
+	unsigned int _num_fields = 0; /**<Used to store number of fields retrieved*/
+	size_t _num_rows = 0; /**<Used to store number of rows retrieved*/
+	vector<Chunk> _chunks; /**<Every chunk in row order.*/
+	vector<size_t> _chunkFirstRows; /**<First row of every chunk, searched to find the chunk of a row.*/
+	vector<vector<char> > _memoryChunks; /**<Serialized chunks that have not been spilled.*/
+	vector<ColumnBuilder> _builders; /**<Chunk being built, one builder per column.*/
+	size_t _builderBytes = 0; /**<Bytes gathered for the chunk being built.*/
+	size_t _memoryBytes = 0; /**<Bytes of the chunks held in memory.*/
+	size_t _spillThreshold; /**<Bytes held in memory before the result spills to disk.*/
+	string _spillDirectory; /**<Directory the temp file is created in, empty for $TMPDIR or /tmp.*/
+	int _fd = -1; /**<Temp file descriptor, -1 while nothing is spilled.*/
+	uint64_t _fileBytes = 0; /**<Bytes written to the temp file.*/
+	char* _map = nullptr; /**<Mapping of the temp file once loading is done.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	bool flushChunk();
+	bool spill();
+	bool writeAll(const char* data, size_t length);
+	bool finish();
+	const Chunk& chunkOf(size_t row) const;
+	const char* columnBlock(size_t row, unsigned int field, size_t& index, size_t& rows) const;
+
+	public:
+	/**
+	 * View of one row with the same operator[], isNull() and size() as a Row (row.h), so code written for a Result
+	 * reads a SpillableResult unchanged. Each cell is looked up in its chunk when it is read.
+	 */
+	class Row
+	{
+		const SpillableResult* _result = nullptr; /**<Result the row belongs to.*/
+		size_t _index = 0; /**<Index of the row.*/
+
+		public:
+		Row() = default;
+		Row(const SpillableResult* result, size_t index) : _result(result), _index(index) {}
+		inline string_view operator[](unsigned int i) const {return _result->cell(_index, i);}
+		inline bool isNull(unsigned int i) const {return _result->isNull(_index, i);}
+		inline unsigned int size() const {return _result->_num_fields;}
+		inline bool isValid() const {return _result != nullptr;}
+	};
+
+	/**
+	 * Iterator over the rows of a SpillableResult, usable in range-based for loops.
+	 */
+	class iterator
+	{
+		const SpillableResult* _result = nullptr; /**<Result being walked.*/
+		size_t _index = 0; /**<Index of the current row.*/
+
+		public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Row;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Row;
+
+		iterator() = default;
+		iterator(const SpillableResult* result, size_t index) : _result(result), _index(index) {}
+		inline Row operator*() const {return Row(_result, _index);}
+		inline iterator& operator++() {++_index; return *this;}
+		inline iterator operator++(int) {iterator tmp = *this; ++_index; return tmp;}
+		inline bool operator==(const iterator& rhs) const {return _index == rhs._index && _result == rhs._result;}
+		inline bool operator!=(const iterator& rhs) const {return !(*this == rhs);}
+	};
+
+	static const size_t CHUNK_ROWS = 65536; /**<Most rows per chunk.*/
+	static const size_t CHUNK_BYTES = 8 * 1024 * 1024; /**<Chunks are closed once their cells pass this many bytes.*/
+
+	explicit SpillableResult(size_t spillThreshold = 256 * 1024 * 1024, const string& spillDirectory = string());
+	SpillableResult(const SpillableResult& result) = delete;
+	SpillableResult& operator=(const SpillableResult& rhs) = delete;
+	SpillableResult(SpillableResult&& result) noexcept;
+	SpillableResult& operator=(SpillableResult&& rhs) noexcept;
+	bool load(Cursor& cursor);
+	void clear();
+	string_view cell(size_t row, unsigned int field) const;
+	bool isNull(size_t row, unsigned int field) const;
+	inline Row operator[](size_t i) const {return Row(this, i);}
+	inline iterator begin() const {return iterator(this, 0);}
+	inline iterator end() const {return iterator(this, _num_rows);}
+	inline bool empty() const {return _num_rows == 0;}
+	inline void setSpillThreshold(size_t bytes) {_spillThreshold = bytes;}
+	inline void setSpillDirectory(const string& directory) {_spillDirectory = directory;}
+	inline size_t getSpillThreshold() const {return _spillThreshold;}
+	inline bool isSpilled() const {return _fd != -1;}
+	inline uint64_t getFileBytes() const {return _fileBytes;}
+	inline size_t getMemoryBytes() const {return _memoryBytes;}
+	inline size_t getNumRows() const {return _num_rows;}
+	inline size_t size() const {return _num_rows;}
+	inline int getNumFields() const {return static_cast<int>(_num_fields);}
+	inline const vector<string>& getFieldNames() const {return _fieldNames;}
+	inline string getError() const {return _error;}
+	~SpillableResult();
+};
+
+#endif // SPILLABLE_RESULT_H
@@ -0,0 +1,150 @@
+/**
+ *
+ * @file sql_lexer.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Allocation free tokenizer for the few SQL checks the connector makes (query cache, statement routing)
+ */
+
+#ifndef SQL_LEXER_H
+#define SQL_LEXER_H
+
+#include <algorithm> /**Library needed to use std::equal*/
+#include <cctype> /**Library needed to use std::isspace, std::isalnum and std::tolower*/
+#include <cstddef> /**Library needed to use std::size_t*/
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+namespace sql
+{
+/**
+ * One token of a SQL statement. String literals come out as a single quote character and comments are skipped.
+ */
+struct Token
+{
+	string_view text; /**<Text of the token.*/
+	bool word = false; /**<If the token is a keyword or identifier rather than punctuation.*/
+};
+
+/**
+ * Checks if a word is in a list, ignoring case.
+ */
+template <size_t N>
+inline bool isOneOf(string_view word, const string_view (&list)[N])
+{
+	for(string_view entry : list)
+	{
+		if(entry.size() == word.size() && std::equal(entry.begin(), entry.end(), word.begin(),
+		                                             [](char a, char b) {return a == std::tolower(static_cast<unsigned char>(b));}))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if a character can be part of an unquoted identifier.
+ */
+inline bool isWordChar(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' || c == '@' || c == '.' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+/**
+ * Splits a SQL statement into tokens without allocating.
+ */
+class Lexer
+{
+	string_view _sql; /**<Statement being split.*/
+	size_t _pos = 0; /**<Offset of the next character to read.*/
+
+	public:
+	explicit Lexer(string_view sql) : _sql(sql) {}
+
+	/**
+	 * Skips a quoted string or identifier, honouring backslash escapes and doubled quotes.
+	 */
+	void skipQuoted(char quote)
+	{
+		for(++_pos; _pos < _sql.size(); ++_pos)
+		{
+			if(_sql[_pos] == '\\' && quote != '`')
+			{
+				++_pos;
+			}
+			else if(_sql[_pos] == quote)
+			{
+				if(_pos + 1 < _sql.size() && _sql[_pos + 1] == quote)
+				{
+					++_pos;
+					continue;
+				}
+				++_pos;
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Reads the next token.
+	 * @return If a token was read or the end of the statement was reached.
+	 */
+	bool next(Token& token)
+	{
+		while(_pos < _sql.size())
+		{
+			char c = _sql[_pos];
+			if(std::isspace(static_cast<unsigned char>(c)))
+			{
+				++_pos;
+			}
+			else if(c == '#' || (c == '-' && _sql.compare(_pos, 2, "--") == 0 &&
+			                     (_pos + 2 == _sql.size() || std::isspace(static_cast<unsigned char>(_sql[_pos + 2])))))
+			{
+				size_t end = _sql.find('\n', _pos);
+				_pos = end == string_view::npos ? _sql.size() : end + 1;
+			}
+			else if(c == '/' && _sql.compare(_pos, 2, "/*") == 0)
+			{
+				size_t end = _sql.find("*/", _pos + 2);
+				_pos = end == string_view::npos ? _sql.size() : end + 2;
+			}
+			else if(c == '\'' || c == '"')
+			{
+				size_t start = _pos;
+				skipQuoted(c);
+				token = Token{_sql.substr(start, 1), false};
+				return true;
+			}
+			else if(c == '`' || isWordChar(c))
+			{
+				size_t start = _pos;
+				while(_pos < _sql.size() && (_sql[_pos] == '`' || isWordChar(_sql[_pos])))
+				{
+					if(_sql[_pos] == '`')
+					{
+						skipQuoted('`');
+					}
+					else
+					{
+						++_pos;
+					}
+				}
+				token = Token{_sql.substr(start, _pos - start), true};
+				return true;
+			}
+			else
+			{
+				token = Token{_sql.substr(_pos, 1), false};
+				++_pos;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+}
+
+#endif // SQL_LEXER_H
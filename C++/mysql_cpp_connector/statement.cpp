@@ -0,0 +1,500 @@
+/**
+ *
+ * @file statement.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector prepared statement source file
+ */
+
+#include "statement.h"
+
+#include <charconv> /**Library needed to use std::from_chars*/
+#include <utility> /**Library needed to use std::exchange*/
+
+/**
+ * Largest buffer handed to the client library up front for a string column. Longer values are fetched again into a grown buffer.
+ */
+static const unsigned long INITIAL_STRING_BUFFER = 256;
+
+/**
+ * Move Constructor
+ * @param stmt Statement whose prepared handle is taken over.
+ */
+Statement::Statement(Statement&& stmt) noexcept :
+	_con{std::exchange(stmt._con, nullptr)},
+	_stmt{std::move(stmt._stmt)},
+	_meta{std::move(stmt._meta)},
+	_sql{std::move(stmt._sql)},
+	_params{std::move(stmt._params)},
+	_paramBuffers{std::move(stmt._paramBuffers)},
+	_results{std::move(stmt._results)},
+	_resultBuffers{std::move(stmt._resultBuffers)},
+	_fieldNames{std::move(stmt._fieldNames)},
+	_executed{std::exchange(stmt._executed, false)},
+	_error{std::move(stmt._error)}
+{
+}
+
+/**
+ * Move assignment operator
+ * @param rhs Statement whose prepared handle is taken over.
+ * @return The current object after the move has been complete.
+ */
+Statement& Statement::operator=(Statement&& rhs) noexcept
+{
+	if(this != &rhs)
+	{
+		close();
+		_con = std::exchange(rhs._con, nullptr);
+		_stmt = std::move(rhs._stmt);
+		_meta = std::move(rhs._meta);
+		_sql = std::move(rhs._sql);
+		_params = std::move(rhs._params);
+		_paramBuffers = std::move(rhs._paramBuffers);
+		_results = std::move(rhs._results);
+		_resultBuffers = std::move(rhs._resultBuffers);
+		_fieldNames = std::move(rhs._fieldNames);
+		_executed = std::exchange(rhs._executed, false);
+		_error = std::move(rhs._error);
+	}
+	return *this;
+}
+
+/**
+ * Has the server parse and plan a statement once so it can be executed repeatedly.
+ * Placeholders are written as ? in the SQL text and start out bound to NULL.
+ * @param con Connection to prepare the statement on.
+ * @param sql stores the statement in a const char* to be prepared.
+ * @return If the statement was prepared or not.
+ */
+bool Statement::prepare(MYSQL* con, const char* sql)
+{
+	string text(sql);
+	close();
+	_error.clear();
+	_con = con;
+	_sql = std::move(text);
+	_stmt.reset(mysql_stmt_init(_con));
+	if(!_stmt)
+	{
+		_error = mysql_error(_con);
+		return false;
+	}
+	if(mysql_stmt_prepare(_stmt.get(), _sql.data(), _sql.size()))
+	{
+		setError();
+		close();
+		return false;
+	}
+
+	unsigned long num_params = mysql_stmt_param_count(_stmt.get());
+	_params.assign(num_params, MYSQL_BIND());
+	_paramBuffers.assign(num_params, Buffer());
+	for(unsigned int i = 0; i < num_params; i++)
+	{
+		bindNull(i);
+	}
+
+	_meta.reset(mysql_stmt_result_metadata(_stmt.get()));
+	if(_meta && !bindResults())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Binds a native buffer to every result column based on the field types the server reported.
+ * Integer columns are fetched as 64 bit integers, FLOAT/DOUBLE as double and everything else as a string.
+ * @return If the result buffers were bound or not.
+ */
+bool Statement::bindResults()
+{
+	unsigned int num_fields = mysql_num_fields(_meta.get());
+	MYSQL_FIELD* fields = mysql_fetch_fields(_meta.get());
+	_results.assign(num_fields, MYSQL_BIND());
+	_resultBuffers.assign(num_fields, Buffer());
+	_fieldNames.clear();
+	for(unsigned int i = 0; i < num_fields; i++)
+	{
+		MYSQL_BIND& bind = _results[i];
+		Buffer& buffer = _resultBuffers[i];
+		_fieldNames.push_back(fields[i].name);
+		switch(fields[i].type)
+		{
+			case MYSQL_TYPE_TINY:
+			case MYSQL_TYPE_SHORT:
+			case MYSQL_TYPE_INT24:
+			case MYSQL_TYPE_LONG:
+			case MYSQL_TYPE_LONGLONG:
+			case MYSQL_TYPE_YEAR:
+				bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				bind.buffer = &buffer.integer;
+				bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+				break;
+			case MYSQL_TYPE_FLOAT:
+			case MYSQL_TYPE_DOUBLE:
+				bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				bind.buffer = &buffer.real;
+				break;
+			default:
+				buffer.bytes.resize(fields[i].length == 0 ? 1 : (fields[i].length < INITIAL_STRING_BUFFER ? fields[i].length : INITIAL_STRING_BUFFER));
+				bind.buffer_type = MYSQL_TYPE_STRING;
+				bind.buffer = buffer.bytes.data();
+				bind.buffer_length = buffer.bytes.size();
+				break;
+		}
+		bind.length = &buffer.length;
+		bind.is_null = &buffer.isNull;
+		bind.error = &buffer.error;
+	}
+
+	if(mysql_stmt_bind_result(_stmt.get(), _results.data()))
+	{
+		setError();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Points a parameter bind at its buffer with the given type.
+ * @param i Zero based placeholder index.
+ * @param type Wire type of the value.
+ * @param isUnsigned If an integer value is unsigned or not.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::setParam(unsigned int i, enum_field_types type, bool isUnsigned)
+{
+	if(i >= _params.size())
+	{
+		_error = "Parameter index " + std::to_string(i) + " is out of range.";
+		return false;
+	}
+	MYSQL_BIND& bind = _params[i];
+	Buffer& buffer = _paramBuffers[i];
+	bind.buffer_type = type;
+	bind.is_unsigned = isUnsigned;
+	bind.is_null = &buffer.isNull;
+	bind.length = &buffer.length;
+	buffer.isNull = 0;
+	return true;
+}
+
+/**
+ * Binds a signed integer to a placeholder.
+ * @param i Zero based placeholder index.
+ * @param value Value to send.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::bindInt64(unsigned int i, int64_t value)
+{
+	if(!setParam(i, MYSQL_TYPE_LONGLONG, false))
+	{
+		return false;
+	}
+	_paramBuffers[i].integer = value;
+	_params[i].buffer = &_paramBuffers[i].integer;
+	return true;
+}
+
+/**
+ * Binds an unsigned integer to a placeholder.
+ * @param i Zero based placeholder index.
+ * @param value Value to send.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::bindUInt64(unsigned int i, uint64_t value)
+{
+	if(!setParam(i, MYSQL_TYPE_LONGLONG, true))
+	{
+		return false;
+	}
+	_paramBuffers[i].integer = static_cast<int64_t>(value);
+	_params[i].buffer = &_paramBuffers[i].integer;
+	return true;
+}
+
+/**
+ * Binds a floating point number to a placeholder.
+ * @param i Zero based placeholder index.
+ * @param value Value to send.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::bindDouble(unsigned int i, double value)
+{
+	if(!setParam(i, MYSQL_TYPE_DOUBLE, false))
+	{
+		return false;
+	}
+	_paramBuffers[i].real = value;
+	_params[i].buffer = &_paramBuffers[i].real;
+	return true;
+}
+
+/**
+ * Binds a string to a placeholder. The bytes are copied, so value does not need to outlive the call.
+ * @param i Zero based placeholder index.
+ * @param value Value to send.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::bindString(unsigned int i, string_view value)
+{
+	if(!setParam(i, MYSQL_TYPE_STRING, false))
+	{
+		return false;
+	}
+	Buffer& buffer = _paramBuffers[i];
+	buffer.bytes.assign(value.begin(), value.end());
+	buffer.length = value.size();
+	_params[i].buffer = buffer.bytes.data();
+	_params[i].buffer_length = buffer.length;
+	return true;
+}
+
+/**
+ * Binds SQL NULL to a placeholder.
+ * @param i Zero based placeholder index.
+ * @return If the placeholder exists or not.
+ */
+bool Statement::bindNull(unsigned int i)
+{
+	if(!setParam(i, MYSQL_TYPE_NULL, false))
+	{
+		return false;
+	}
+	_paramBuffers[i].isNull = 1;
+	_params[i].buffer = nullptr;
+	return true;
+}
+
+/**
+ * Executes the prepared statement with the currently bound parameters.
+ * Any rows of a previous execution that were not fetched are discarded.
+ * @return If the statement was executed or not.
+ */
+bool Statement::execute()
+{
+	if(!_stmt)
+	{
+		_error = "Statement has not been prepared.";
+		return false;
+	}
+	_error.clear();
+	if(_executed)
+	{
+		mysql_stmt_free_result(_stmt.get());
+		_executed = false;
+	}
+	if(!_params.empty() && mysql_stmt_bind_param(_stmt.get(), _params.data()))
+	{
+		setError();
+		return false;
+	}
+	if(mysql_stmt_execute(_stmt.get()))
+	{
+		setError();
+		return false;
+	}
+	_executed = _meta != nullptr;
+	return true;
+}
+
+/**
+ * Reads the next row of the result into the column buffers.
+ * String columns longer than their buffer are grown and fetched again, so values are never truncated.
+ * @return If a row was read or not. Check getError() once this returns false to tell the end of the rows from a failure.
+ */
+bool Statement::fetch()
+{
+	if(!_executed)
+	{
+		return false;
+	}
+
+	int rc = mysql_stmt_fetch(_stmt.get());
+	if(rc == MYSQL_NO_DATA)
+	{
+		_executed = false;
+		return false;
+	}
+	if(rc == 1)
+	{
+		setError();
+		_executed = false;
+		return false;
+	}
+	if(rc == MYSQL_DATA_TRUNCATED)
+	{
+		bool grown = false;
+		for(unsigned int i = 0; i < _results.size(); i++)
+		{
+			MYSQL_BIND& bind = _results[i];
+			Buffer& buffer = _resultBuffers[i];
+			if(!buffer.error || bind.buffer_type != MYSQL_TYPE_STRING || buffer.length <= buffer.bytes.size())
+			{
+				continue;
+			}
+			buffer.bytes.resize(buffer.length);
+			bind.buffer = buffer.bytes.data();
+			bind.buffer_length = buffer.bytes.size();
+			if(mysql_stmt_fetch_column(_stmt.get(), &bind, i, 0))
+			{
+				setError();
+				return false;
+			}
+			grown = true;
+		}
+		if(grown && mysql_stmt_bind_result(_stmt.get(), _results.data()))
+		{
+			setError();
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Closes the statement on the server and releases every buffer.
+ */
+void Statement::close()
+{
+	_meta.reset();
+	_stmt.reset();
+	_sql.clear();
+	_params.clear();
+	_paramBuffers.clear();
+	_results.clear();
+	_resultBuffers.clear();
+	_fieldNames.clear();
+	_executed = false;
+}
+
+/**
+ * Checks a column of the current row for NULL.
+ * @param i Zero based column index.
+ * @return If the column is NULL or not.
+ */
+bool Statement::isNull(unsigned int i) const
+{
+	return _resultBuffers[i].isNull != 0;
+}
+
+/**
+ * Reads a column of the current row as a signed integer.
+ * Floating point columns are truncated and string columns are parsed, yielding 0 when they do not hold a number.
+ * @param i Zero based column index.
+ * @return The column value, 0 for NULL.
+ */
+int64_t Statement::getInt64(unsigned int i) const
+{
+	const Buffer& buffer = _resultBuffers[i];
+	if(buffer.isNull)
+	{
+		return 0;
+	}
+	switch(_results[i].buffer_type)
+	{
+		case MYSQL_TYPE_LONGLONG:
+			return buffer.integer;
+		case MYSQL_TYPE_DOUBLE:
+			return static_cast<int64_t>(buffer.real);
+		default:
+		{
+			int64_t value = 0;
+			string_view text = getString(i);
+			std::from_chars(text.data(), text.data() + text.size(), value);
+			return value;
+		}
+	}
+}
+
+/**
+ * Reads a column of the current row as an unsigned integer.
+ * @param i Zero based column index.
+ * @see Statement::getInt64(unsigned int i)
+ * @return The column value, 0 for NULL.
+ */
+uint64_t Statement::getUInt64(unsigned int i) const
+{
+	const Buffer& buffer = _resultBuffers[i];
+	if(buffer.isNull)
+	{
+		return 0;
+	}
+	switch(_results[i].buffer_type)
+	{
+		case MYSQL_TYPE_LONGLONG:
+			return static_cast<uint64_t>(buffer.integer);
+		case MYSQL_TYPE_DOUBLE:
+			return static_cast<uint64_t>(buffer.real);
+		default:
+		{
+			uint64_t value = 0;
+			string_view text = getString(i);
+			std::from_chars(text.data(), text.data() + text.size(), value);
+			return value;
+		}
+	}
+}
+
+/**
+ * Reads a column of the current row as a floating point number.
+ * Integer columns are converted and string columns are parsed, yielding 0 when they do not hold a number.
+ * @param i Zero based column index.
+ * @return The column value, 0 for NULL.
+ */
+double Statement::getDouble(unsigned int i) const
+{
+	const Buffer& buffer = _resultBuffers[i];
+	if(buffer.isNull)
+	{
+		return 0.0;
+	}
+	switch(_results[i].buffer_type)
+	{
+		case MYSQL_TYPE_LONGLONG:
+			return _results[i].is_unsigned ? static_cast<double>(static_cast<uint64_t>(buffer.integer)) : static_cast<double>(buffer.integer);
+		case MYSQL_TYPE_DOUBLE:
+			return buffer.real;
+		default:
+		{
+			double value = 0.0;
+			string_view text = getString(i);
+			std::from_chars(text.data(), text.data() + text.size(), value);
+			return value;
+		}
+	}
+}
+
+/**
+ * Reads a column of the current row as raw bytes. Only string columns (everything that is not an integer or FLOAT/DOUBLE) carry bytes.
+ * @param i Zero based column index.
+ * @return View of the column value, valid until the next fetch(). Empty for NULL and numeric columns.
+ */
+string_view Statement::getString(unsigned int i) const
+{
+	const Buffer& buffer = _resultBuffers[i];
+	if(buffer.isNull || _results[i].buffer_type != MYSQL_TYPE_STRING)
+	{
+		return string_view();
+	}
+	return string_view(buffer.bytes.data(), buffer.length < buffer.bytes.size() ? buffer.length : buffer.bytes.size());
+}
+
+/**
+ * Copies the last statement error into the error string.
+ */
+void Statement::setError()
+{
+	_error = mysql_stmt_error(_stmt.get());
+}
+
+/**
+ * Basic Destructor
+ */
+Statement::~Statement()
+{
+	close();
+}
@@ -0,0 +1,105 @@
+/**
+ *
+ * @file statement.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Server-side prepared statement using the MySQL binary protocol
+ */
+
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstdint> /**Library needed to use std::int64_t and std::uint64_t*/
+#include <type_traits> /**Library needed to use std::remove_pointer_t*/
+
+#include <vector> /**Library needed to use std::vector*/
+using std::vector;
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "handles.h" /**Header needed to use StatementHandle and ResultHandle*/
+
+/**
+ * Wraps a MYSQL_STMT. The SQL is parsed by the server once in prepare() and can then be executed any number
+ * of times with new parameter values. Parameters and results travel in the binary protocol, so numbers are
+ * never formatted to text on the way out nor parsed from text on the way back.
+ *
+ * Typical use: prepare() once, then for every execution bind the parameters, execute(), and loop on fetch()
+ * reading the current row with the typed getters. Rows are not buffered on the client; a new execute() discards
+ * whatever rows of the previous one were not fetched.
+ */
+class Statement
+{
+	/**
+	 * Type MYSQL_BIND uses for its flags (my_bool before MySQL 8.0, bool since).
+	 */
+	using BindBool = std::remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+
+	/**
+	 * Storage a MYSQL_BIND points at. Lives in a vector parallel to the binds.
+	 */
+	struct Buffer
+	{
+		int64_t integer = 0; /**<Value of integer parameters and columns.*/
+		double real = 0.0; /**<Value of floating point parameters and columns.*/
+		vector<char> bytes; /**<Value of string parameters and columns.*/
+		unsigned long length = 0; /**<Length of the value in bytes, set by the client library for columns.*/
+		BindBool isNull = 0; /**<Set when the value is NULL.*/
+		BindBool error = 0; /**<Set by the client library when a column value was truncated.*/
+	};
+
+	MYSQL* _con = nullptr; /**<Connection the statement was prepared on.*/
+	StatementHandle _stmt; /**<MySQL Statement C structure.*/
+	ResultHandle _meta; /**<Result set metadata, nullptr when the statement returns no rows.*/
+	string _sql; /**<SQL text the statement was prepared from.*/
+	vector<MYSQL_BIND> _params; /**<Parameter binds, one per placeholder.*/
+	vector<Buffer> _paramBuffers; /**<Storage for _params.*/
+	vector<MYSQL_BIND> _results; /**<Result column binds, one per field.*/
+	vector<Buffer> _resultBuffers; /**<Storage for _results.*/
+	vector<string> _fieldNames; /**<Vector of std::string used to store field names retrieved.*/
+	bool _executed = false; /**<Boolean that stores if the statement has a pending result set*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	bool bindResults();
+	bool setParam(unsigned int i, enum_field_types type, bool isUnsigned);
+	void setError();
+
+	public:
+	Statement() = default;
+	Statement(const Statement& stmt) = delete;
+	Statement& operator=(const Statement& rhs) = delete;
+	Statement(Statement&& stmt) noexcept;
+	Statement& operator=(Statement&& rhs) noexcept;
+	bool prepare(MYSQL* con, const char* sql);
+	bool bindInt64(unsigned int i, int64_t value);
+	bool bindUInt64(unsigned int i, uint64_t value);
+	bool bindDouble(unsigned int i, double value);
+	bool bindString(unsigned int i, string_view value);
+	bool bindNull(unsigned int i);
+	bool execute();
+	bool fetch();
+	void close();
+	bool isNull(unsigned int i) const;
+	int64_t getInt64(unsigned int i) const;
+	uint64_t getUInt64(unsigned int i) const;
+	double getDouble(unsigned int i) const;
+	string_view getString(unsigned int i) const;
+	inline bool isPrepared() const {return _stmt != nullptr;}
+	inline string getError() const {return _error;}
+	inline const string& getSQL() const {return _sql;}
+	inline unsigned long getParamCount() const {return _params.size();}
+	inline int getNumFields() const {return static_cast<int>(_results.size());}
+	inline const vector<string>& getFieldNames() const {return _fieldNames;}
+	inline my_ulonglong getNumAffectedRows() const {return _stmt ? mysql_stmt_affected_rows(_stmt.get()) : 0;}
+	inline my_ulonglong getInsertId() const {return _stmt ? mysql_stmt_insert_id(_stmt.get()) : 0;}
+	inline MYSQL_STMT* getMYSQL_STMT_Ptr() const {return _stmt.get();}
+	~Statement();
+};
+
+#endif // STATEMENT_H
@@ -0,0 +1,115 @@
+/**
+ *
+ * @file statement_cache.cpp
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief MySQL CPP Connector statement cache source file
+ */
+
+#include "statement_cache.h"
+
+#include <iterator> /**Library needed to use std::prev*/
+
+/**
+ * Basic Constructor
+ * @param capacity Most statements kept at once. At least one statement is always kept.
+ */
+StatementCache::StatementCache(size_t capacity) :
+	_capacity(capacity ? capacity : 1)
+{
+}
+
+/**
+ * Looks up the prepared statement for some SQL, preparing it when it is not cached yet or was prepared in a session
+ * that has since been replaced by a reconnect.
+ * @param con Connection to prepare on.
+ * @param sql SQL text of the statement, compared byte for byte.
+ * @return The prepared statement, owned by the cache and valid until it is evicted, or nullptr when preparing failed.
+ */
+Statement* StatementCache::get(MYSQL* con, const char* sql)
+{
+	_error.clear();
+	unsigned long threadId = mysql_thread_id(con);
+	auto found = _index.find(string_view(sql));
+	if(found != _index.end())
+	{
+		EntryList::iterator it = found->second;
+		_lru.splice(_lru.begin(), _lru, it);
+		if(it->threadId == threadId && it->stmt.isPrepared())
+		{
+			_hits++;
+			return &it->stmt;
+		}
+		_reprepares++;
+		if(!it->stmt.prepare(con, it->sql.c_str()))
+		{
+			_error = it->stmt.getError();
+			_index.erase(found);
+			_lru.erase(it);
+			return nullptr;
+		}
+		it->threadId = threadId;
+		return &it->stmt;
+	}
+
+	_misses++;
+	Entry entry;
+	entry.sql = sql;
+	if(!entry.stmt.prepare(con, sql))
+	{
+		_error = entry.stmt.getError();
+		return nullptr;
+	}
+	entry.threadId = threadId;
+	_lru.push_front(std::move(entry));
+	_index.emplace(string_view(_lru.front().sql), _lru.begin());
+	while(_lru.size() > _capacity)
+	{
+		EntryList::iterator last = std::prev(_lru.end());
+		_index.erase(string_view(last->sql));
+		_lru.erase(last);
+	}
+	return &_lru.front().stmt;
+}
+
+/**
+ * Closes and forgets the statement for some SQL, for example after a schema change made it fail.
+ * @param sql SQL text of the statement.
+ * @return If the statement was cached or not.
+ */
+bool StatementCache::erase(const char* sql)
+{
+	auto found = _index.find(string_view(sql));
+	if(found == _index.end())
+	{
+		return false;
+	}
+	EntryList::iterator it = found->second;
+	_index.erase(found);
+	_lru.erase(it);
+	return true;
+}
+
+/**
+ * Closes and forgets every statement.
+ */
+void StatementCache::clear()
+{
+	_index.clear();
+	_lru.clear();
+}
+
+/**
+ * Changes how many statements are kept, closing the least recently used ones if there are too many.
+ * @param capacity Most statements kept at once. At least one statement is always kept.
+ */
+void StatementCache::setCapacity(size_t capacity)
+{
+	_capacity = capacity ? capacity : 1;
+	while(_lru.size() > _capacity)
+	{
+		EntryList::iterator last = std::prev(_lru.end());
+		_index.erase(string_view(last->sql));
+		_lru.erase(last);
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ *
+ * @file statement_cache.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Per-connection LRU cache of prepared statements keyed by SQL text
+ */
+
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::uint64_t*/
+#include <list> /**Library needed to use std::list*/
+#include <unordered_map> /**Library needed to use std::unordered_map*/
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+#include <string_view> /**Library needed to use std::string_view*/
+using std::string_view;
+
+#include "statement.h" /**Header needed to use Statement*/
+
+/**
+ * Keeps up to a fixed number of prepared Statements for one connection so running the same SQL again costs a single
+ * execute round trip instead of a prepare and an execute. The least recently used statement is closed once the cache
+ * is full. Statements belong to the server session they were prepared in; when the connection is re-established
+ * (seen as a new mysql_thread_id) each cached statement is prepared again the next time it is asked for.
+ * Like the connection it belongs to, a StatementCache must only be used by one thread at a time.
+ */
+class StatementCache
+{
+	/**
+	 * One cached statement.
+	 */
+	struct Entry
+	{
+		string sql; /**<SQL text the statement was prepared from, also the key in _index.*/
+		Statement stmt; /**<The prepared statement.*/
+		unsigned long threadId = 0; /**<Server session the statement was prepared in.*/
+	};
+
+	using EntryList = std::list<Entry>;
+
+	EntryList _lru; /**<Every cached statement, most recently used first.*/
+	std::unordered_map<string_view, EntryList::iterator> _index; /**<Statements by SQL text, keys point into Entry::sql.*/
+	size_t _capacity; /**<Most statements kept at once.*/
+	uint64_t _hits = 0; /**<Lookups answered with an already prepared statement.*/
+	uint64_t _misses = 0; /**<Lookups that had to prepare a new statement.*/
+	uint64_t _reprepares = 0; /**<Cached statements prepared again after a reconnect.*/
+	string _error; /**<String that stores any error messages that is encountered*/
+
+	public:
+	explicit StatementCache(size_t capacity = 64);
+	StatementCache(const StatementCache& cache) = delete;
+	StatementCache& operator=(const StatementCache& rhs) = delete;
+	StatementCache(StatementCache&& cache) = default;
+	StatementCache& operator=(StatementCache&& rhs) = default;
+	Statement* get(MYSQL* con, const char* sql);
+	bool erase(const char* sql);
+	void clear();
+	void setCapacity(size_t capacity);
+	inline size_t getCapacity() const {return _capacity;}
+	inline size_t size() const {return _lru.size();}
+	inline uint64_t getNumHits() const {return _hits;}
+	inline uint64_t getNumMisses() const {return _misses;}
+	inline uint64_t getNumReprepares() const {return _reprepares;}
+	inline string getError() const {return _error;}
+};
+
+#endif // STATEMENT_CACHE_H
@@ -0,0 +1,284 @@
+/**
+ *
+ * @file typed_row.h
+ * @author Garry Rice
+ * @date 10/17/2026
+ * @brief Compile-time mapping of result rows onto tuples and structs
+ */
+
+#ifndef TYPED_ROW_H
+#define TYPED_ROW_H
+
+#include <mysql.h> /**MySQL header needed for MySQL C library*/
+
+#include <charconv> /**Library needed to use std::from_chars*/
+#include <cstddef> /**Library needed to use std::size_t*/
+#include <cstdint> /**Library needed to use std::int64_t*/
+#include <optional> /**Library needed to use std::optional*/
+#include <tuple> /**Library needed to use std::tuple and std::tie*/
+#include <type_traits> /**Library needed to use std::enable_if_t and std::void_t*/
+#include <utility> /**Library needed to use std::index_sequence*/
+
+#include <string> /**Library needed to use std::string*/
+using std::string;
+
+/**
+ * Declares the members of a struct that Connector::queryAs fills, in column order:
+ *
+ *     struct Account
+ *     {
+ *         int64_t id;
+ *         std::string name;
+ *         std::optional<double> balance;
+ *         CONNECTOR_ROW(id, name, balance)
+ *     };
+ */
+#define CONNECTOR_ROW(...) auto rowTie() {return std::tie(__VA_ARGS__);}
+
+/**
+ * Checks if a field holds whole numbers.
+ * @param type Type of the field.
+ * @return If the field is TINYINT through BIGINT or YEAR.
+ */
+inline bool isIntegerField(enum_field_types type)
+{
+	return type == MYSQL_TYPE_TINY || type == MYSQL_TYPE_SHORT || type == MYSQL_TYPE_INT24 || type == MYSQL_TYPE_LONG ||
+	       type == MYSQL_TYPE_LONGLONG || type == MYSQL_TYPE_YEAR;
+}
+
+/**
+ * Checks if a field holds numbers, whole or not.
+ * @param type Type of the field.
+ * @return If the field is an integer, FLOAT, DOUBLE or DECIMAL.
+ */
+inline bool isNumericField(enum_field_types type)
+{
+	return isIntegerField(type) || type == MYSQL_TYPE_FLOAT || type == MYSQL_TYPE_DOUBLE || type == MYSQL_TYPE_DECIMAL ||
+	       type == MYSQL_TYPE_NEWDECIMAL;
+}
+
+/**
+ * Decodes the text of one cell into a C++ type. Only the specializations below exist, so mapping a column onto any
+ * other type fails to compile. accepts() is checked once per result, decode() runs for every non-NULL cell.
+ */
+template <typename T, typename = void>
+struct ColumnDecoder;
+
+/**
+ * Integers, decoded with std::from_chars. Values out of range for T fail to decode.
+ */
+template <typename T>
+struct ColumnDecoder<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> > >
+{
+	static constexpr const char* NAME = "an integer";
+	static bool accepts(const MYSQL_FIELD& field) {return isIntegerField(field.type);}
+	static bool decode(const char* data, unsigned long length, T& out)
+	{
+		std::from_chars_result parsed = std::from_chars(data, data + length, out);
+		return parsed.ec == std::errc() && parsed.ptr == data + length;
+	}
+};
+
+/**
+ * Booleans, read from integer columns (BOOL is TINYINT(1)). Anything but 0 is true.
+ */
+template <>
+struct ColumnDecoder<bool>
+{
+	static constexpr const char* NAME = "a bool";
+	static bool accepts(const MYSQL_FIELD& field) {return isIntegerField(field.type);}
+	static bool decode(const char* data, unsigned long length, bool& out)
+	{
+		int64_t value = 0;
+		if(!ColumnDecoder<int64_t>::decode(data, length, value))
+		{
+			return false;
+		}
+		out = value != 0;
+		return true;
+	}
+};
+
+/**
+ * Floating point numbers, read from any numeric column.
+ */
+template <typename T>
+struct ColumnDecoder<T, std::enable_if_t<std::is_floating_point_v<T> > >
+{
+	static constexpr const char* NAME = "a floating point number";
+	static bool accepts(const MYSQL_FIELD& field) {return isNumericField(field.type);}
+	static bool decode(const char* data, unsigned long length, T& out)
+	{
+		std::from_chars_result parsed = std::from_chars(data, data + length, out);
+		return parsed.ec == std::errc() && parsed.ptr == data + length;
+	}
+};
+
+/**
+ * Strings, read from any column since every value has a text form.
+ */
+template <>
+struct ColumnDecoder<string>
+{
+	static constexpr const char* NAME = "a string";
+	static bool accepts(const MYSQL_FIELD&) {return true;}
+	static bool decode(const char* data, unsigned long length, string& out)
+	{
+		out.assign(data, length);
+		return true;
+	}
+};
+
+/**
+ * Nullable columns. Any type above wrapped in std::optional, left empty for SQL NULL.
+ */
+template <typename T>
+struct ColumnDecoder<std::optional<T> >
+{
+	static constexpr const char* NAME = ColumnDecoder<T>::NAME;
+	static bool accepts(const MYSQL_FIELD& field) {return ColumnDecoder<T>::accepts(field);}
+	static bool decode(const char* data, unsigned long length, std::optional<T>& out)
+	{
+		return ColumnDecoder<T>::decode(data, length, out.emplace());
+	}
+};
+
+/**
+ * Checks if a type is a std::optional.
+ */
+template <typename T>
+struct IsOptional : std::false_type {};
+
+/**
+ * Checks if a type is a std::optional.
+ */
+template <typename T>
+struct IsOptional<std::optional<T> > : std::true_type {};
+
+/**
+ * Maps whole rows onto a tuple of values or references. The loops over the columns are unrolled at compile time,
+ * so decoding a row is a straight sequence of calls to the right ColumnDecoder, with no per-cell type switch.
+ */
+template <typename Tuple>
+struct TupleMapper;
+
+/**
+ * Maps whole rows onto a tuple of values or references.
+ */
+template <typename... Ts>
+struct TupleMapper<std::tuple<Ts...> >
+{
+	static constexpr unsigned int COLUMNS = sizeof...(Ts); /**<Number of columns a row must have.*/
+
+	/**
+	 * Checks the fields of a result against the types of the tuple.
+	 * @param fields Field descriptions of the result.
+	 * @param num_fields Number of fields.
+	 * @param error Receives why the result cannot be mapped.
+	 * @return If every row of the result can be mapped or not.
+	 */
+	static bool check(const MYSQL_FIELD* fields, unsigned int num_fields, string& error)
+	{
+		if(num_fields != COLUMNS)
+		{
+			error = "Result has " + std::to_string(num_fields) + " columns but the row type has " + std::to_string(COLUMNS) + ".";
+			return false;
+		}
+		return checkColumns(fields, error, std::index_sequence_for<Ts...>());
+	}
+
+	/**
+	 * Decodes one row.
+	 * @param row Row to decode.
+	 * @param lengths Cell lengths of the row.
+	 * @param values Tuple receiving the values.
+	 * @param error Receives why the row could not be decoded.
+	 * @return If every cell was decoded or not.
+	 */
+	template <typename Target>
+	static bool decode(MYSQL_ROW row, const unsigned long* lengths, Target&& values, string& error)
+	{
+		return decodeColumns(row, lengths, values, error, std::index_sequence_for<Ts...>());
+	}
+
+	private:
+	template <size_t... I>
+	static bool checkColumns(const MYSQL_FIELD* fields, string& error, std::index_sequence<I...>)
+	{
+		return (checkColumn<std::decay_t<Ts> >(fields[I], I, error) && ...);
+	}
+
+	template <typename T>
+	static bool checkColumn(const MYSQL_FIELD& field, size_t index, string& error)
+	{
+		if(ColumnDecoder<T>::accepts(field))
+		{
+			return true;
+		}
+		error = "Column " + std::to_string(index) + " (" + field.name + ") cannot be read as " + ColumnDecoder<T>::NAME + ".";
+		return false;
+	}
+
+	template <typename Target, size_t... I>
+	static bool decodeColumns(MYSQL_ROW row, const unsigned long* lengths, Target& values, string& error, std::index_sequence<I...>)
+	{
+		return (decodeCell(row[I], lengths[I], std::get<I>(values), I, error) && ...);
+	}
+
+	template <typename T>
+	static bool decodeCell(const char* data, unsigned long length, T& out, size_t index, string& error)
+	{
+		if(!data)
+		{
+			if constexpr(IsOptional<T>::value)
+			{
+				out.reset();
+				return true;
+			}
+			else
+			{
+				error = "Column " + std::to_string(index) + " is NULL, map it onto a std::optional.";
+				return false;
+			}
+		}
+		if(!ColumnDecoder<T>::decode(data, length, out))
+		{
+			error = "Column " + std::to_string(index) + " value '" + string(data, length) + "' cannot be read as " + ColumnDecoder<T>::NAME + ".";
+			return false;
+		}
+		return true;
+	}
+};
+
+/**
+ * Maps whole rows onto T. Single values map one column.
+ */
+template <typename T, typename = void>
+struct RowMapper
+{
+	static bool check(const MYSQL_FIELD* fields, unsigned int num_fields, string& error) {return TupleMapper<std::tuple<T&> >::check(fields, num_fields, error);}
+	static bool decode(MYSQL_ROW row, const unsigned long* lengths, T& out, string& error) {return TupleMapper<std::tuple<T&> >::decode(row, lengths, std::tie(out), error);}
+};
+
+/**
+ * Maps whole rows onto a std::tuple, one column per element.
+ */
+template <typename... Ts>
+struct RowMapper<std::tuple<Ts...> >
+{
+	static bool check(const MYSQL_FIELD* fields, unsigned int num_fields, string& error) {return TupleMapper<std::tuple<Ts...> >::check(fields, num_fields, error);}
+	static bool decode(MYSQL_ROW row, const unsigned long* lengths, std::tuple<Ts...>& out, string& error) {return TupleMapper<std::tuple<Ts...> >::decode(row, lengths, out, error);}
+};
+
+/**
+ * Maps whole rows onto a struct declaring its members with CONNECTOR_ROW, one column per member.
+ */
+template <typename T>
+struct RowMapper<T, std::void_t<decltype(std::declval<T&>().rowTie())> >
+{
+	using Tie = decltype(std::declval<T&>().rowTie());
+	static bool check(const MYSQL_FIELD* fields, unsigned int num_fields, string& error) {return TupleMapper<Tie>::check(fields, num_fields, error);}
+	static bool decode(MYSQL_ROW row, const unsigned long* lengths, T& out, string& error) {return TupleMapper<Tie>::decode(row, lengths, out.rowTie(), error);}
+};
+
+#endif // TYPED_ROW_H